@@ -0,0 +1,149 @@
+#include "corosig/container/Allocator.hpp"
+#include "corosig/container/FlatHashMap.hpp"
+#include "corosig/container/Vector.hpp"
+
+#include <algorithm>
+#include <boost/intrusive/avl_set.hpp>
+#include <boost/intrusive/avl_set_hook.hpp>
+#include <boost/intrusive/options.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace corosig;
+
+constexpr size_t MEMORY = static_cast<size_t>(64) * 1024 * 1024;
+
+// NOLINTNEXTLINE(bugprone-throwing-static-initialization)
+auto g_mem = std::make_unique<Allocator::Memory<MEMORY>>();
+
+std::vector<std::string> make_names(size_t amount) {
+  std::vector<std::string> names;
+  names.reserve(amount);
+  for (size_t i = 0; i < amount; ++i) {
+    names.push_back(std::format("host-{}.region-{}.example.com", i * 7919 % 100003, i % 17));
+  }
+  return names;
+}
+
+// Same shape as the name nodes of dns::MemoryCache
+struct AvlNode : boost::intrusive::avl_set_base_hook<boost::intrusive::optimize_size<true>> {
+  std::string_view name;
+  uint16_t value = 0;
+
+  friend bool operator<(AvlNode const &lhs, AvlNode const &rhs) noexcept {
+    return lhs.name < rhs.name;
+  }
+};
+
+struct AvlNodeKey {
+  using type = std::string_view;
+
+  type operator()(AvlNode const &node) const noexcept {
+    return node.name;
+  }
+};
+
+using AvlSet = boost::intrusive::avl_set<AvlNode, boost::intrusive::key_of_value<AvlNodeKey>>;
+
+// Same shape as the buckets of dns::detail::CompressionMap
+struct SortedNode {
+  std::string_view name;
+  uint16_t value = 0;
+
+  friend bool operator<(SortedNode const &lhs, SortedNode const &rhs) noexcept {
+    return lhs.name < rhs.name;
+  }
+};
+
+} // namespace
+
+TEST_CASE("Benchmark lookup-only maps") {
+  size_t const amount = GENERATE(8, 64, 1024, 16384);
+  std::vector<std::string> names = make_names(amount);
+
+  Allocator alloc{*g_mem};
+
+  BENCHMARK(std::format("FlatHashMap: insert {} names", amount)) {
+    FlatHashMap<std::string_view, uint16_t> map{alloc};
+    for (size_t i = 0; i < names.size(); ++i) {
+      REQUIRE(map.try_emplace(names[i], static_cast<uint16_t>(i)));
+    }
+    return map.size();
+  };
+
+  BENCHMARK(std::format("avl_set: insert {} names", amount)) {
+    std::vector<AvlNode> nodes(names.size());
+    AvlSet set;
+    for (size_t i = 0; i < names.size(); ++i) {
+      nodes[i].name = names[i];
+      set.insert(nodes[i]);
+    }
+    size_t size = set.size();
+    set.clear();
+    return size;
+  };
+
+  BENCHMARK(std::format("sorted Vector: insert {} names", amount)) {
+    Vector<SortedNode> buckets{alloc};
+    for (size_t i = 0; i < names.size(); ++i) {
+      SortedNode node{names[i], static_cast<uint16_t>(i)};
+      auto it = std::upper_bound(buckets.begin(), buckets.end(), node);
+      REQUIRE(buckets.insert(it, std::move(node)));
+    }
+    return buckets.size();
+  };
+
+  FlatHashMap<std::string_view, uint16_t> map{alloc};
+  std::vector<AvlNode> nodes(names.size());
+  AvlSet set;
+  Vector<SortedNode> buckets{alloc};
+  for (size_t i = 0; i < names.size(); ++i) {
+    REQUIRE(map.try_emplace(names[i], static_cast<uint16_t>(i)));
+    nodes[i].name = names[i];
+    set.insert(nodes[i]);
+    REQUIRE(buckets.push_back(SortedNode{names[i], static_cast<uint16_t>(i)}));
+  }
+  std::sort(buckets.begin(), buckets.end());
+
+  // look up copies of the names, so that keys are compared by contents, not by address
+  std::vector<std::string> queries = names;
+  std::reverse(queries.begin(), queries.end());
+
+  BENCHMARK(std::format("FlatHashMap: look up {} names", amount)) {
+    size_t found = 0;
+    for (std::string const &query : queries) {
+      found += static_cast<size_t>(map.contains(std::string_view{query}));
+    }
+    return found;
+  };
+
+  BENCHMARK(std::format("avl_set: look up {} names", amount)) {
+    size_t found = 0;
+    for (std::string const &query : queries) {
+      found += static_cast<size_t>(set.find(std::string_view{query}) != set.end());
+    }
+    return found;
+  };
+
+  BENCHMARK(std::format("sorted Vector: look up {} names", amount)) {
+    size_t found = 0;
+    for (std::string const &query : queries) {
+      SortedNode node{query};
+      auto it = std::lower_bound(buckets.begin(), buckets.end(), node);
+      found += static_cast<size_t>(it != buckets.end() && it->name == node.name);
+    }
+    return found;
+  };
+
+  set.clear();
+}
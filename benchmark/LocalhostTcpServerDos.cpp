@@ -6,6 +6,7 @@
 #include "corosig/io/TcpSocket.hpp"
 #include "corosig/reactor/Reactor.hpp"
 
+#include <array>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -82,12 +83,15 @@ void benchmark_body(std::span<char> mem, size_t num_connections) {
 
     addr = listener.address().value();
 
-    for (size_t i = 0; i < num_connections; ++i) {
-      auto server_opt = co_await listener.accept(r);
-      if (!server_opt) {
-        FAIL(server_opt.error().description());
+    std::array<AcceptResult, 64> accepted;
+    for (size_t i = 0; i < num_connections;) {
+      auto count_opt = co_await listener.accept_batch(r, accepted);
+      if (!count_opt) {
+        FAIL(count_opt.error().description());
+      }
+      for (size_t j = 0; j < count_opt.value(); ++j, ++i) {
+        REQUIRE(SERVER_TASK(r, std::move(accepted[j].incoming_connection)));
       }
-      REQUIRE(SERVER_TASK(r, std::move(server_opt.value().incoming_connection)));
     }
   };
 
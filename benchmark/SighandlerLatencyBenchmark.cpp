@@ -0,0 +1,85 @@
+#include "corosig/Coro.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/Sighandler.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+namespace {
+
+using namespace corosig;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t REACTOR_MEMORY = static_cast<size_t>(64) * 1024;
+constexpr size_t ITERATIONS = 100000;
+
+Clock::time_point g_entered;
+void (*g_rearm)(int) noexcept = nullptr;
+
+/// Timestamp is taken first thing in the coroutine. Handler is re-armed only afterwards, so the
+/// measured span is exactly from raise to the first user coroutine
+Fut<void> mark_entry(Reactor &, int sig) noexcept {
+  g_entered = Clock::now();
+  g_rearm(sig);
+  co_return Ok{};
+}
+
+void rearm_set_sighandler(int sig) noexcept {
+  (void)std::signal(sig, detail::sighandler<REACTOR_MEMORY, mark_entry>);
+}
+
+void rearm_install_sighandler(int sig) noexcept {
+  (void)detail::install_sigaction(sig,
+                                  &detail::PreparedSighandler<REACTOR_MEMORY, mark_entry>::handle);
+}
+
+void bare_handler(int) noexcept {
+  g_entered = Clock::now();
+}
+
+void measure_latency(char const *description) {
+  std::vector<Clock::duration> samples;
+  samples.reserve(ITERATIONS);
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    g_entered = {};
+    Clock::time_point raised = Clock::now();
+    REQUIRE(::raise(SIGUSR1) == 0);
+    REQUIRE(g_entered != Clock::time_point{});
+    samples.push_back(g_entered - raised);
+  }
+
+  std::ranges::sort(samples);
+  auto in_ns = [](Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  };
+  std::cout << '\n'
+            << description << "\n  median " << in_ns(samples[samples.size() / 2]) << " ns, p99 "
+            << in_ns(samples[samples.size() * 99 / 100]) << " ns\n";
+}
+
+} // namespace
+
+TEST_CASE("Benchmark time from signal delivery to the first coroutine") {
+  g_rearm = rearm_set_sighandler;
+  set_sighandler<REACTOR_MEMORY, mark_entry>(SIGUSR1);
+  measure_latency("set_sighandler, reactor built on stack at delivery");
+
+  g_rearm = rearm_install_sighandler;
+  REQUIRE(install_sighandler<REACTOR_MEMORY, mark_entry>(SIGUSR1));
+  measure_latency("install_sighandler, prepared reactor on alternate stack");
+
+  struct sigaction action {};
+  action.sa_handler = bare_handler;
+  action.sa_flags = SA_ONSTACK;
+  REQUIRE(::sigaction(SIGUSR1, &action, nullptr) == 0);
+  measure_latency("bare sigaction handler, for reference");
+
+  (void)std::signal(SIGUSR1, SIG_DFL);
+}
@@ -0,0 +1,103 @@
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/UdpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sys/socket.h>
+
+namespace {
+
+using namespace corosig;
+
+constexpr size_t DATAGRAM_SIZE = 1200;
+constexpr size_t DATAGRAMS_PER_ROUND = 256;
+constexpr size_t ROUNDS = 64;
+constexpr auto REACTOR_MEMORY = static_cast<size_t>(1024) * 64;
+
+auto g_mem = std::make_unique<Allocator::Memory<REACTOR_MEMORY>>(); // NOLINT
+std::array<char, DATAGRAM_SIZE * DATAGRAMS_PER_ROUND> g_payload{};   // NOLINT
+
+Fut<void, Error<AllocationError, SyscallError>>
+send_one_by_one(Reactor &r, UdpSocket &sock, SockaddrStorage const &dest) noexcept {
+  for (size_t i = 0; i < DATAGRAMS_PER_ROUND; ++i) {
+    auto datagram = std::span{g_payload}.subspan(i * DATAGRAM_SIZE, DATAGRAM_SIZE);
+    COROSIG_CO_TRYV(co_await sock.send_to(r, datagram, dest));
+  }
+  co_return Ok{};
+}
+
+Fut<void, Error<AllocationError, SyscallError>>
+send_in_batches(Reactor &r, UdpSocket &sock, SockaddrStorage const &dest) noexcept {
+  std::array<OutgoingDatagram, DATAGRAMS_PER_ROUND> batch;
+  for (size_t i = 0; i < DATAGRAMS_PER_ROUND; ++i) {
+    batch[i] = OutgoingDatagram{
+        .data = std::span{g_payload}.subspan(i * DATAGRAM_SIZE, DATAGRAM_SIZE),
+        .dest = &dest,
+    };
+  }
+  COROSIG_CO_TRYV(co_await sock.send_batch(r, batch));
+  co_return Ok{};
+}
+
+Fut<void, Error<AllocationError, SyscallError>>
+send_segmented(Reactor &r, UdpSocket &sock, SockaddrStorage const &dest) noexcept {
+  COROSIG_CO_TRYV(co_await sock.send_segmented(r, g_payload, DATAGRAM_SIZE, dest));
+  co_return Ok{};
+}
+
+template <typename F>
+void generic_benchmark(char const *description, F &&send_round) {
+  Reactor reactor{*g_mem};
+
+  // Nobody reads from the sink, so its queue overflows and kernel drops datagrams. Only the
+  // sending side is measured
+  auto sink = UdpSocket::bound(Ipv4Addr::loopback().to_sockaddr());
+  REQUIRE(sink);
+  auto dest = sink.value().address();
+  REQUIRE(dest);
+  auto sock = UdpSocket::unbound();
+  REQUIRE(sock);
+
+  auto run_rounds = [&]() {
+    for (size_t i = 0; i < ROUNDS; ++i) {
+      REQUIRE(send_round(reactor, sock.value(), dest.value()).block_on());
+    }
+  };
+
+  BENCHMARK(description) {
+    run_rounds();
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  run_rounds();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "\n"
+            << description << ": "
+            << static_cast<double>(ROUNDS * DATAGRAMS_PER_ROUND) / elapsed.count()
+            << " datagrams per second\n";
+}
+
+} // namespace
+
+TEST_CASE("Benchmark sending datagrams one by one") {
+  generic_benchmark("Send 16384 datagrams with send_to", send_one_by_one);
+}
+
+TEST_CASE("Benchmark sending datagrams in batches") {
+  generic_benchmark("Send 16384 datagrams with send_batch", send_in_batches);
+}
+
+TEST_CASE("Benchmark sending segmented datagrams") {
+  generic_benchmark("Send 16384 datagrams with send_segmented", send_segmented);
+}
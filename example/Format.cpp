@@ -0,0 +1,47 @@
+/// Format a crash report with corosig's own formatter. Format strings are checked at compile time
+/// and text goes straight into a buffered writer, without allocations, locale or building an
+/// intermediate string. Compare with StdFormat.cpp
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Format.hpp"
+#include "corosig/Sighandler.hpp"
+#include "corosig/io/BufWriter.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/Stdio.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <unistd.h>
+
+namespace {
+
+corosig::Fut<void, corosig::Error<corosig::AllocationError, corosig::SyscallError>>
+sighandler(corosig::Reactor &r, int signal) noexcept {
+  using namespace corosig;
+  BufWriter out{STDOUT, r.allocator(), 256};
+  COROSIG_CO_TRYV(co_await print(r, out, "Signal {} occured for process {}\n", signal, getpid()));
+  COROSIG_CO_TRYV(co_await print(r,
+                                 out,
+                                 "Handler is at {}, last error: {}\n",
+                                 reinterpret_cast<void const *>(&sighandler),
+                                 SyscallError{EINTR}));
+  COROSIG_CO_TRYV(co_await print(r, out, "Peer: {}\n", Ipv4Addr::loopback().to_sockaddr(8080)));
+  COROSIG_CO_TRYV(co_await out.flush(r));
+  co_return Ok{};
+}
+
+} // namespace
+
+int main(int, char **) {
+  try {
+    corosig::set_sighandler<4096, sighandler>(SIGFPE);
+    ::raise(SIGFPE);
+    return EXIT_SUCCESS;
+  } catch (std::exception const &) {
+    return EXIT_FAILURE;
+  }
+}
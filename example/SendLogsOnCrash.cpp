@@ -12,6 +12,7 @@
 #include "corosig/Result.hpp"
 #include "corosig/Sighandler.hpp"
 #include "corosig/io/File.hpp"
+#include "corosig/io/PreparedFileSet.hpp"
 #include "corosig/io/Sockaddr.hpp"
 #include "corosig/io/Stdio.hpp"
 #include "corosig/io/TcpSocket.hpp"
@@ -19,12 +20,15 @@
 #include "corosig/io/dns/HostsFileCache.hpp"
 #include "corosig/reactor/Reactor.hpp"
 
+#include <algorithm>
+#include <array>
 #include <csignal>
 #include <cstddef>
 #include <cstdlib>
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <span>
 #include <string_view>
 #include <system_error>
 #include <thread>
@@ -104,15 +108,16 @@ using namespace corosig;
 SockaddrStorage const TCP_SERVER_ADDR = Ipv4Addr::loopback().to_sockaddr(8080);
 SockaddrStorage const UDP_SERVER_ADDR = Ipv4Addr::loopback().to_sockaddr(9090);
 
-constexpr std::string_view FILE1 = "file1.log";
-constexpr std::string_view FILE2 = "file2.log";
+// Files are created and allocated at startup, so handler only writes into them
+PreparedFileSet prepared_files;
 
-Fut<void, Error<AllocationError, SyscallError>> write_to_file(Reactor &r,
-                                                              char const *path) noexcept {
-  using enum File::OpenFlags;
-  COROSIG_CO_TRY(auto file, co_await File::open(r, path, CREATE | TRUNCATE | WRONLY));
+Fut<void, Error<AllocationError, SyscallError>> write_to_file(Reactor &r) noexcept {
+  File *file = prepared_files.acquire();
+  if (file == nullptr) {
+    co_return Failure{SyscallError{ENFILE}};
+  }
   for (auto &log : logs_buffer) {
-    COROSIG_CO_TRYV(co_await file.write(r, log));
+    COROSIG_CO_TRYV(co_await file->write(r, log));
   }
   co_return Ok{};
 }
@@ -137,8 +142,13 @@ Fut<void, Error<AllocationError, SyscallError>> send_via_tcp(Reactor &r) {
 
 Fut<void, Error<AllocationError, SyscallError>> send_via_udp(Reactor &r) {
   COROSIG_CO_TRY(auto socket, UdpSocket::unbound());
-  for (auto &log : logs_buffer) {
-    COROSIG_CO_TRYV(co_await socket.send_to(r, log, UDP_SERVER_ADDR));
+  std::array<OutgoingDatagram, UdpSocket::MAX_BATCH_SIZE> batch;
+  for (size_t i = 0; i < logs_buffer.size(); i += batch.size()) {
+    size_t count = std::min(batch.size(), logs_buffer.size() - i);
+    for (size_t j = 0; j < count; ++j) {
+      batch[j] = OutgoingDatagram{.data = logs_buffer[i + j], .dest = &UDP_SERVER_ADDR};
+    }
+    COROSIG_CO_TRYV(co_await socket.send_batch(r, std::span{batch}.first(count)));
   }
   co_return Ok{};
 };
@@ -147,8 +157,8 @@ Fut<void, Error<AllocationError, SyscallError>> sighandler(Reactor &r, int) noex
   dns::HostsFileCache hosts_file{r, "/etc/hosts"};
 
   Result res = co_await when_all_succeed(r,
-                                         write_to_file(r, FILE1.data()),
-                                         write_to_file(r, FILE2.data()),
+                                         write_to_file(r),
+                                         write_to_file(r),
                                          send_via_tcp(r),
                                          send_via_udp(r),
                                          write_to_stdout(r));
@@ -175,6 +185,12 @@ Fut<void, Error<AllocationError, SyscallError>> sighandler(Reactor &r, int) noex
 
 int main() {
   try {
+    std::array<char const *, 2> log_paths{FILE1.data(), FILE2.data()};
+    if (auto prepared = sighandling::prepared_files.prepare({.paths = log_paths}); !prepared) {
+      std::cerr << "Failed to prepare log files: " << prepared.error().description() << '\n';
+      return EXIT_FAILURE;
+    }
+
     constexpr auto REACTOR_MEMORY = 8 * 1024;
     for (auto signal : {SIGILL, SIGFPE, SIGTERM, SIGABRT}) {
       corosig::set_sighandler<REACTOR_MEMORY, sighandling::sighandler>(signal);
@@ -195,6 +211,9 @@ int main() {
 
     ::raise(SIGFPE);
 
+    // Trim files down to what the handler has written
+    (void)sighandling::prepared_files.close();
+
     {
       std::ifstream file{FILE1.data()};
       if (!file.is_open()) {
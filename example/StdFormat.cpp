@@ -3,10 +3,13 @@
 /// some of pushes fail. Moreover, if by some reason one push fails, but next ones are ok, you will
 /// have a vector without one element in the middle. Such behaviour may be unwanted in some
 /// scenarios
+/// Also note global operator new interposition: if std::format decides to allocate something on
+/// it's own, memory is taken from reactor instead of global heap
 
 #include "corosig/Coro.hpp"
 #include "corosig/ErrorTypes.hpp"
 #include "corosig/Sighandler.hpp"
+#include "corosig/container/NewInterposition.hpp"
 #include "corosig/container/Vector.hpp"
 #include "corosig/io/Stdio.hpp"
 #include "corosig/reactor/Reactor.hpp"
@@ -17,13 +20,18 @@
 #include <format>
 #include <unistd.h>
 
+COROSIG_DEFINE_GLOBAL_NEW_INTERPOSITION();
+
 namespace {
 
 corosig::Fut<void, corosig::Error<corosig::AllocationError, corosig::SyscallError>>
 sighandler(corosig::Reactor &r, int signal) noexcept {
   using namespace corosig;
   Vector<char> string{r.allocator()};
-  std::format_to(std::back_inserter(string), "Signal occured for process\n", signal, getpid());
+  {
+    ScopedNewInterposition interposition{r.allocator()};
+    std::format_to(std::back_inserter(string), "Signal occured for process\n", signal, getpid());
+  }
   COROSIG_CO_TRYV(co_await STDOUT.write(r, string));
   co_return corosig::Ok{};
 }
@@ -0,0 +1,105 @@
+#ifndef COROSIG_CRASH_HELPER_HPP
+#define COROSIG_CRASH_HELPER_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <sys/types.h>
+
+namespace corosig {
+
+/// @brief A helper process forked at startup which ships logs on behalf of a crashed one. Crashing
+///        process only stages bytes into shared memory and hands them off with a single write to a
+///        pipe, then may exit right away. Helper wakes up, runs a handler in its own Reactor with
+///        nothing of the signal context and its limits, and exits
+/// @code
+/// Fut<void, Error<AllocationError, SyscallError>> ship(Reactor &, std::span<char const>) noexcept;
+///
+/// // at startup
+/// static CrashHelper helper;
+/// COROSIG_TRYV(helper.start({.staging_size = 1 << 20, .handler = ship}));
+/// // in a signal handler
+/// helper.stage("fatal signal\n");
+/// helper.hand_off();
+/// @endcode
+struct CrashHelper {
+  /// @brief Handler to run in helper process with bytes staged by the crashed one
+  using Handler = Fut<void, Error<AllocationError, SyscallError>> (*)(
+      Reactor &, std::span<char const> staged) noexcept;
+
+  struct Options {
+    /// @brief Size of shared memory region to stage bytes into
+    size_t staging_size = size_t{64} * 1024;
+
+    /// @brief Size of memory for helper's Reactor
+    size_t reactor_memory = size_t{64} * 1024;
+
+    /// @brief Handler to run after hand off
+    Handler handler = nullptr;
+  };
+
+  /// @brief Make a helper which is not running. Call start to fork it
+  CrashHelper() noexcept = default;
+
+  CrashHelper(CrashHelper const &) = delete;
+  CrashHelper(CrashHelper &&) = delete;
+  CrashHelper &operator=(CrashHelper const &) = delete;
+  CrashHelper &operator=(CrashHelper &&) = delete;
+
+  /// @brief Calls stop
+  ~CrashHelper();
+
+  /// @brief Map staging region and fork helper process. Helper inherits all descriptors which are
+  ///        open at this point, so connections prepared before start may be used by handler
+  /// @note Blocking. Meant to be called at startup, not from signal handler
+  Result<void, SyscallError> start(Options const &) noexcept;
+
+  /// @brief Let helper exit without running handler unless bytes were handed off, then wait for it
+  ///        and unmap staging region
+  /// @returns Exit status of helper, as returned by waitpid
+  /// @note Blocking. Meant to be called at shutdown, not from signal handler
+  Result<int, SyscallError> stop() noexcept;
+
+  /// @brief Copy bytes into staging region after previously staged ones. Bytes which do not fit are
+  ///        dropped
+  /// @returns Amount of bytes staged
+  /// @note Thread-safe and async-signal-safe. Makes no syscalls
+  size_t stage(std::span<char const>) noexcept;
+
+  /// @brief Stage bytes from string literal, excluding null-terminator
+  template <size_t N>
+  size_t stage(char const (&arr)[N]) noexcept // NOLINT(modernize-avoid-c-arrays)
+  {
+    return stage(std::string_view{arr});
+  }
+
+  /// @brief Wake helper to run handler with bytes staged so far. Only the first call has effect
+  /// @note Async-signal-safe
+  Result<void, SyscallError> hand_off() noexcept;
+
+  /// @brief Get id of helper process or -1 if it is not running
+  [[nodiscard]] pid_t pid() const noexcept;
+
+  /// @brief Get amount of bytes staged so far
+  [[nodiscard]] size_t staged() const noexcept;
+
+private:
+  struct Shared;
+
+  [[noreturn]] static void helper_main(Shared &, os::Handle wake_fd, Options const &) noexcept;
+
+  Shared *m_shared = nullptr;
+  size_t m_mapping_size = 0;
+  os::Handle m_wake_fd = -1;
+  pid_t m_pid = -1;
+};
+
+} // namespace corosig
+
+#endif
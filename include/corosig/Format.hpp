@@ -0,0 +1,445 @@
+#ifndef COROSIG_FORMAT_HPP
+#define COROSIG_FORMAT_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/BufWriter.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace corosig {
+
+/// @brief Parsed replacement field of a format string. Syntax is a subset of std::format's:
+///        {[:[<|>][#][0][width][type]]}
+struct FormatSpec {
+  /// @brief Presentation type, or '\0' for default one
+  char type = '\0';
+  /// @brief '<', '>' or '\0' for default alignment, which is right for numbers and left for text
+  char align = '\0';
+  /// @brief '#' was specified. Adds 0x, 0b or 0 prefix to integers
+  bool alternate = false;
+  /// @brief '0' was specified. Pads integers with zeros after prefix instead of spaces
+  bool zero_pad = false;
+  uint8_t width = 0;
+};
+
+/// @brief Bytes to be formatted as space-separated hex pairs. Formatted as lowercase by default
+///        or as uppercase with {:X}
+struct HexDump {
+  std::span<std::byte const> bytes;
+};
+
+/// @brief Make a HexDump over object representation of elements of data
+template <typename T>
+HexDump hex_dump(std::span<T const> data) noexcept {
+  return HexDump{std::as_bytes(data)};
+}
+
+/// @brief Make a HexDump over characters of data
+inline HexDump hex_dump(std::string_view data) noexcept {
+  return hex_dump(std::span<char const>{data});
+}
+
+namespace detail {
+
+/// Size of chunks on stack text is formatted in when it goes anywhere but into a span
+constexpr size_t FORMAT_CHUNK_SIZE = 128;
+
+/// Sink of formatted text. Writes into a buffer and, when buffer is full, either hands it over to
+/// drain or, if there is no drain, drops the rest while still counting it
+struct FormatOutput {
+  using Drain = void (*)(void *context, std::string_view) noexcept;
+
+  explicit FormatOutput(std::span<char> buffer,
+                        Drain drain = nullptr,
+                        void *context = nullptr) noexcept
+      : m_buffer{buffer},
+        m_drain{drain},
+        m_context{context} {
+  }
+
+  void put(std::string_view) noexcept;
+  void put(char) noexcept;
+  void fill(char, size_t count) noexcept;
+  /// Put literal part of a format string, replacing {{ and }} with single braces
+  void put_literal(std::string_view, bool has_escapes) noexcept;
+  /// Hand everything buffered to drain
+  void finish() noexcept;
+
+  /// Amount of bytes kept in buffer
+  [[nodiscard]] size_t used() const noexcept {
+    return m_used;
+  }
+
+  /// Amount of bytes produced, including drained and dropped ones
+  [[nodiscard]] size_t total() const noexcept {
+    return m_total;
+  }
+
+private:
+  std::span<char> m_buffer;
+  size_t m_used = 0;
+  size_t m_total = 0;
+  Drain m_drain;
+  void *m_context;
+};
+
+enum class FormatKind : uint8_t {
+  INTEGER,
+  CHAR,
+  BOOL,
+  POINTER,
+  STRING,
+  OTHER,
+};
+
+template <typename T>
+consteval FormatKind format_kind() noexcept {
+  using enum FormatKind;
+  if constexpr (std::same_as<T, bool>) {
+    return BOOL;
+  } else if constexpr (std::same_as<T, char>) {
+    return CHAR;
+  } else if constexpr (std::integral<T>) {
+    return INTEGER;
+  } else if constexpr (std::same_as<T, std::nullptr_t>) {
+    return POINTER;
+  } else if constexpr (std::convertible_to<T const &, std::string_view>) {
+    return STRING;
+  } else if constexpr (std::is_pointer_v<T>) {
+    return POINTER;
+  } else {
+    return OTHER;
+  }
+}
+
+/// Presentation types allowed for T. Default type is always allowed
+template <typename T>
+consteval std::string_view allowed_format_types() noexcept {
+  using enum FormatKind;
+  switch (format_kind<T>()) {
+  case INTEGER:
+    return "dxXbo";
+  case CHAR:
+    return "c";
+  case BOOL:
+  case STRING:
+    return "s";
+  case POINTER:
+    return "p";
+  case OTHER:
+    if constexpr (std::same_as<T, HexDump>) {
+      return "xX";
+    }
+    return "";
+  }
+  return "";
+}
+
+/// Not constexpr on purpose: being reached while evaluating a FormatString constructor makes it a
+/// compilation error which mentions the reason
+inline void invalid_format_string(char const * /*reason*/) noexcept {
+}
+
+void format_integer(FormatOutput &, FormatSpec const &, uint64_t magnitude, bool negative) noexcept;
+void format_pointer(FormatOutput &, FormatSpec const &, uintptr_t) noexcept;
+void format_string(FormatOutput &, FormatSpec const &, std::string_view) noexcept;
+
+/// Pad and then format value which is not an integer. Value is formatted twice if padding is
+/// requested: first time only to measure it
+template <typename FORMAT>
+void format_padded(FormatOutput &out, FormatSpec const &spec, bool left, FORMAT &&format) noexcept {
+  if (spec.width == 0) {
+    format(out);
+    return;
+  }
+
+  FormatOutput measure{std::span<char>{}};
+  format(measure);
+  size_t padding = spec.width > measure.total() ? spec.width - measure.total() : 0;
+  bool pad_right = spec.align == '<' || (spec.align == '\0' && left);
+  if (!pad_right) {
+    out.fill(' ', padding);
+  }
+  format(out);
+  if (pad_right) {
+    out.fill(' ', padding);
+  }
+}
+
+} // namespace detail
+
+/// @brief Format bytes as space-separated hex pairs
+void format_value(detail::FormatOutput &, FormatSpec const &, HexDump const &) noexcept;
+
+/// @brief Format syscall error as it's description followed by errno value
+void format_value(detail::FormatOutput &, FormatSpec const &, SyscallError const &) noexcept;
+
+/// @brief Format address in dotted-decimal notation
+void format_value(detail::FormatOutput &, FormatSpec const &, Ipv4Addr const &) noexcept;
+
+/// @brief Format address in RFC 5952 canonical notation
+void format_value(detail::FormatOutput &, FormatSpec const &, Ipv6Addr const &) noexcept;
+
+/// @brief Format address as either Ipv4 or Ipv6 one
+void format_value(detail::FormatOutput &, FormatSpec const &, IpvNAddr const &) noexcept;
+
+/// @brief Format socket address as ip:port, [ipv6]:port or unix socket path
+void format_value(detail::FormatOutput &, FormatSpec const &, SockaddrStorage const &) noexcept;
+
+namespace detail {
+
+template <typename T>
+void format_arg(FormatOutput &out, FormatSpec const &spec, T const &value) noexcept {
+  using enum FormatKind;
+  constexpr FormatKind KIND = format_kind<T>();
+  if constexpr (KIND == INTEGER) {
+    bool negative = false;
+    auto magnitude = static_cast<uint64_t>(value);
+    if constexpr (std::is_signed_v<T>) {
+      negative = value < 0;
+      magnitude = negative ? 0 - magnitude : magnitude;
+    }
+    format_integer(out, spec, magnitude, negative);
+  } else if constexpr (KIND == CHAR) {
+    format_string(out, spec, std::string_view{&value, 1});
+  } else if constexpr (KIND == BOOL) {
+    format_string(out, spec, value ? "true" : "false");
+  } else if constexpr (KIND == STRING) {
+    if constexpr (std::is_pointer_v<T>) {
+      format_string(out, spec, value == nullptr ? "(null)" : std::string_view{value});
+    } else {
+      format_string(out, spec, std::string_view{value});
+    }
+  } else if constexpr (KIND == POINTER) {
+    if constexpr (std::same_as<T, std::nullptr_t>) {
+      format_pointer(out, spec, 0);
+    } else {
+      format_pointer(out, spec, reinterpret_cast<uintptr_t>(value));
+    }
+  } else {
+    format_padded(out, spec, false, [&](FormatOutput &o) { format_value(o, spec, value); });
+  }
+}
+
+} // namespace detail
+
+/// @brief Format string which is parsed and checked against argument types at compile time.
+///        Supports automatic indexing only. Values of user types are formatted by format_value
+///        overloads found by ADL
+template <typename... ARGS>
+struct FormatString {
+  template <typename S>
+    requires std::convertible_to<S const &, std::string_view>
+  consteval FormatString(S const &str) noexcept // NOLINT(google-explicit-constructor)
+      : m_str{str} {
+    constexpr std::array<std::string_view, sizeof...(ARGS)> ALLOWED_TYPES = {
+        detail::allowed_format_types<std::remove_cvref_t<ARGS>>()...};
+
+    size_t arg = 0;
+    size_t i = 0;
+    while (i < m_str.size()) {
+      if (m_str[i] == '}') {
+        if (i + 1 == m_str.size() || m_str[i + 1] != '}') {
+          detail::invalid_format_string("unmatched '}'");
+        }
+        m_has_escapes = true;
+        i += 2;
+        continue;
+      }
+      if (m_str[i] != '{') {
+        ++i;
+        continue;
+      }
+      if (i + 1 < m_str.size() && m_str[i + 1] == '{') {
+        m_has_escapes = true;
+        i += 2;
+        continue;
+      }
+
+      size_t close = m_str.find('}', i);
+      if (close == std::string_view::npos) {
+        detail::invalid_format_string("unterminated replacement field");
+      }
+      if (arg == sizeof...(ARGS)) {
+        detail::invalid_format_string("more replacement fields than arguments");
+      }
+
+      FormatSpec spec = parse_spec(m_str.substr(i + 1, close - i - 1));
+      if (spec.type != '\0' && ALLOWED_TYPES[arg].find(spec.type) == std::string_view::npos) {
+        detail::invalid_format_string("presentation type is not supported by argument");
+      }
+      m_fields[arg] = Field{.begin = i, .end = close + 1, .spec = spec};
+      ++arg;
+      i = close + 1;
+    }
+
+    if (arg != sizeof...(ARGS)) {
+      detail::invalid_format_string("less replacement fields than arguments");
+    }
+  }
+
+  /// @brief Get the format string itself
+  [[nodiscard]] constexpr std::string_view get() const noexcept {
+    return m_str;
+  }
+
+  /// @brief Write formatted arguments into out
+  void format(detail::FormatOutput &out, ARGS const &...args) const noexcept {
+    size_t i = 0;
+    size_t literal_begin = 0;
+    auto format_one = [&](auto const &arg) {
+      Field const &field = m_fields[i];
+      out.put_literal(m_str.substr(literal_begin, field.begin - literal_begin), m_has_escapes);
+      detail::format_arg(out, field.spec, arg);
+      literal_begin = field.end;
+      ++i;
+    };
+    (format_one(args), ...);
+    out.put_literal(m_str.substr(literal_begin), m_has_escapes);
+  }
+
+private:
+  struct Field {
+    size_t begin = 0;
+    size_t end = 0;
+    FormatSpec spec;
+  };
+
+  static consteval FormatSpec parse_spec(std::string_view str) noexcept {
+    FormatSpec spec;
+    if (str.empty()) {
+      return spec;
+    }
+    if (str.front() != ':') {
+      detail::invalid_format_string("only automatic argument indexing is supported");
+    }
+    str.remove_prefix(1);
+
+    if (!str.empty() && (str.front() == '<' || str.front() == '>')) {
+      spec.align = str.front();
+      str.remove_prefix(1);
+    }
+    if (!str.empty() && str.front() == '#') {
+      spec.alternate = true;
+      str.remove_prefix(1);
+    }
+    if (!str.empty() && str.front() == '0') {
+      spec.zero_pad = true;
+      str.remove_prefix(1);
+    }
+
+    size_t width = 0;
+    while (!str.empty() && str.front() >= '0' && str.front() <= '9') {
+      width = width * 10 + static_cast<size_t>(str.front() - '0');
+      str.remove_prefix(1);
+    }
+    if (width > UINT8_MAX) {
+      detail::invalid_format_string("width is too large");
+    }
+    spec.width = static_cast<uint8_t>(width);
+
+    if (!str.empty()) {
+      spec.type = str.front();
+      str.remove_prefix(1);
+    }
+    if (!str.empty()) {
+      detail::invalid_format_string("unsupported format specification");
+    }
+    return spec;
+  }
+
+  std::string_view m_str;
+  std::array<Field, sizeof...(ARGS)> m_fields = {};
+  bool m_has_escapes = false;
+};
+
+/// @brief Result of formatting into a fixed buffer
+struct FormatToResult {
+  /// @brief Part of the buffer which holds formatted text
+  std::span<char> written;
+  /// @brief Length of the whole formatted text, which may be larger than written part
+  size_t size = 0;
+
+  /// @brief Tell if formatted text did not fit into the buffer
+  [[nodiscard]] bool truncated() const noexcept {
+    return written.size() < size;
+  }
+};
+
+/// @brief Format args into out. Text which does not fit is dropped. Never allocates and never
+///        touches locale or any other global state, so is safe to call from a signal handler
+/// @code
+/// std::array<char, 128> buf;
+/// auto res = format_to(buf, "signal {} at {:#x}, peer {}\n", signal, address, peer_sockaddr);
+/// @endcode
+template <typename... ARGS>
+FormatToResult format_to(std::span<char> out,
+                         FormatString<std::type_identity_t<ARGS>...> fmt,
+                         ARGS const &...args) noexcept {
+  detail::FormatOutput output{out};
+  fmt.format(output, args...);
+  return FormatToResult{.written = out.first(output.used()), .size = output.total()};
+}
+
+/// @brief Format args into output iterator, such as BufWriter::OutputIterator. Text is produced in
+///        small chunks on stack and then copied into out
+template <std::output_iterator<char const &> OUT, typename... ARGS>
+OUT format_to(OUT out,
+              FormatString<std::type_identity_t<ARGS>...> fmt,
+              ARGS const &...args) noexcept {
+  std::array<char, detail::FORMAT_CHUNK_SIZE> chunk;
+  detail::FormatOutput output{chunk, [](void *context, std::string_view text) noexcept {
+                                OUT &it = *static_cast<OUT *>(context);
+                                it = std::ranges::copy(text, std::move(it)).out;
+                              },
+                              &out};
+  fmt.format(output, args...);
+  output.finish();
+  return out;
+}
+
+/// @brief Get the length of formatted text without writing it anywhere
+template <typename... ARGS>
+size_t formatted_size(FormatString<std::type_identity_t<ARGS>...> fmt,
+                      ARGS const &...args) noexcept {
+  detail::FormatOutput output{std::span<char>{}};
+  fmt.format(output, args...);
+  return output.total();
+}
+
+/// @brief Format args into a buffered writer. Text is formatted once, straight into the buffer,
+///        which is flushed afterwards if it has got full. Completes without suspending if text
+///        fits into buffer
+/// @returns AllocationError if buffer can't be allocated or grown to hold text
+/// @note Text which does not fit into free space of the buffer grows it past its capacity until
+///       the flush, since formatting can't stop to wait for the sink
+template <typename SINK, typename ALLOCATOR, typename... ARGS>
+Fut<void, Error<AllocationError, SyscallError>>
+print(Reactor &r,
+      BufWriter<SINK, ALLOCATOR> &out,
+      FormatString<std::type_identity_t<ARGS>...> fmt,
+      ARGS const &...args) noexcept {
+  using Future = Fut<void, Error<AllocationError, SyscallError>>;
+
+  format_to(out.out(), fmt, args...);
+  if (out.buffered().size() <= out.capacity() && !out.failed()) {
+    return Future::make_ready(Ok{});
+  }
+  return out.flush(r);
+}
+
+} // namespace corosig
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef COROSIG_MEMORY_PROFILER_HPP
+#define COROSIG_MEMORY_PROFILER_HPP
+
+#include "corosig/container/Allocator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace corosig {
+
+/// @brief Collects statistics about allocations made through an Allocator: peak usage, a
+///        distribution of allocation sizes and the places allocations are made from. Meant to be
+///        used during a dry run of a signal handler to choose a memory budget for it instead of
+///        guessing one
+struct MemoryProfiler final : Allocator::Observer {
+  /// @brief Amount of power-of-2 buckets in the allocation size histogram. The last one counts
+  ///        all allocations which do not fit into the previous ones
+  constexpr static size_t SIZE_BUCKETS = 24;
+
+  /// @brief Maximum amount of distinct call sites tracked. Allocations from the other call sites
+  ///        are still counted by all the other statistics
+  constexpr static size_t MAX_CALL_SITES = 32;
+
+  /// @brief Allocations made from a single place in code
+  struct CallSite {
+    void const *address = nullptr;
+    size_t allocations = 0;
+    size_t total_bytes = 0;
+    size_t max_bytes = 0;
+  };
+
+  /// @brief Start observing an allocator. The allocator shall outlive the profiler
+  explicit MemoryProfiler(Allocator &) noexcept;
+
+  MemoryProfiler(MemoryProfiler const &) = delete;
+  MemoryProfiler(MemoryProfiler &&) = delete;
+  MemoryProfiler &operator=(MemoryProfiler const &) = delete;
+  MemoryProfiler &operator=(MemoryProfiler &&) = delete;
+
+  /// @brief Stop observing the allocator
+  ~MemoryProfiler();
+
+  void on_allocate(void *ptr, size_t size, void const *call_site) noexcept override;
+  void on_deallocate(void *ptr) noexcept override;
+
+  /// @brief Get the maximum amount of memory used by observed allocator, in bytes. Includes
+  ///        allocator's per-chunk overhead and allocations made before the profiler was attached
+  [[nodiscard]] size_t peak_memory() const noexcept;
+
+  /// @brief Get the amount of successful allocations
+  [[nodiscard]] size_t allocations() const noexcept;
+
+  /// @brief Get the amount of allocations which have failed
+  [[nodiscard]] size_t failed_allocations() const noexcept;
+
+  /// @brief Get the maximum amount of simultaneously alive allocations
+  [[nodiscard]] size_t peak_live_allocations() const noexcept;
+
+  /// @brief Get the histogram of requested allocation sizes. Bucket i counts allocations with
+  ///        size in range [2^(i-1), 2^i), bucket 0 counts allocations of size 0
+  [[nodiscard]] std::span<size_t const, SIZE_BUCKETS> size_histogram() const noexcept;
+
+  /// @brief Get all the tracked call sites, sorted by total bytes allocated from them
+  [[nodiscard]] std::span<CallSite const> call_sites() noexcept;
+
+  /// @brief Get a memory budget which covers the observed peak with some headroom, rounded up
+  ///        to a whole KiB
+  [[nodiscard]] size_t recommended_budget(size_t headroom_percent = 25) const noexcept;
+
+  /// @brief Format a human-readable report into buffer
+  /// @param configured_budget Budget the handler currently runs with or 0 if unknown
+  /// @returns Formatted part of the buffer. The report is truncated if buffer is too small
+  [[nodiscard]] std::string_view format_report(std::span<char> buffer,
+                                               size_t configured_budget = 0) noexcept;
+
+private:
+  Allocator &m_alloc;
+  std::array<size_t, SIZE_BUCKETS> m_size_histogram{};
+  std::array<CallSite, MAX_CALL_SITES> m_call_sites{};
+  size_t m_call_sites_amount = 0;
+  size_t m_allocations = 0;
+  size_t m_failed_allocations = 0;
+  size_t m_live_allocations = 0;
+  size_t m_peak_live_allocations = 0;
+};
+
+} // namespace corosig
+
+#endif
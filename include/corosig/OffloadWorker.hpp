@@ -0,0 +1,134 @@
+#ifndef COROSIG_OFFLOAD_WORKER_HPP
+#define COROSIG_OFFLOAD_WORKER_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/os/Handle.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+#include <span>
+#include <sys/stat.h>
+#include <type_traits>
+
+namespace corosig {
+
+/// @brief A thread spawned in advance which makes syscalls that cannot be made nonblocking, such as
+///        open, fsync or stat, so a signal handler keeps polling its other futures meanwhile.
+///        Worker sleeps on a futex until a call is submitted and reports completion through an
+///        eventfd which the submitting coroutine polls like any other handle. Neither submitting
+///        nor completing a call allocates or creates threads. A future of a submitted call may be
+///        dropped, for example by with_deadline. Worker then throws its result away
+struct OffloadWorker {
+  /// @brief Maximum amount of calls in flight. Submitters yield until a slot is freed
+  constexpr static size_t MAX_PENDING = 8;
+
+  /// @brief Maximum size of arguments of a single call
+  constexpr static size_t MAX_ARGS_SIZE = 512;
+
+  /// @brief A call to make on worker thread with a pointer to a copy of its arguments. Returns -1
+  ///        with errno set on failure
+  using Call = long (*)(void *args) noexcept;
+
+  /// @brief Make a worker which is not running. Calls are made inline until start is called
+  OffloadWorker() noexcept = default;
+
+  OffloadWorker(OffloadWorker const &) = delete;
+  OffloadWorker(OffloadWorker &&) = delete;
+  OffloadWorker &operator=(OffloadWorker const &) = delete;
+  OffloadWorker &operator=(OffloadWorker &&) = delete;
+
+  /// @brief Calls stop
+  ~OffloadWorker();
+
+  /// @brief Create completion eventfds and spawn worker thread with all signals blocked
+  /// @returns ENOSYS on systems without futex and eventfd
+  /// @note Blocking. Meant to be called at startup, not from signal handler
+  Result<void, SyscallError> start() noexcept;
+
+  /// @brief Let worker finish submitted calls, join it and close completion eventfds
+  /// @note Blocking. Meant to be called at shutdown, not from signal handler
+  void stop() noexcept;
+
+  /// @brief Tell if worker thread is running
+  [[nodiscard]] bool running() const noexcept;
+
+  /// @brief Make call on worker thread. Arguments are copied into the call's slot, so the future
+  ///        may be dropped while call is in flight, and copied back once it completes, so call may
+  ///        use them for output. If worker is not running, call is made inline with args
+  ///        themselves, blocking the reactor for its duration
+  /// @returns Result of call or errno it has left on failure
+  Fut<long, Error<AllocationError, SyscallError>>
+  run(Reactor &, Call, std::span<std::byte> args = {}) noexcept;
+
+  /// @brief Same as above for arguments stored in a trivially copyable object
+  template <typename ARGS>
+    requires std::is_trivially_copyable_v<ARGS>
+  Fut<long, Error<AllocationError, SyscallError>> run(Reactor &r, Call call, ARGS &args) noexcept {
+    static_assert(sizeof(ARGS) <= MAX_ARGS_SIZE, "Arguments do not fit into a slot");
+    return run(r, call, std::as_writable_bytes(std::span{&args, 1}));
+  }
+
+  /// @brief Open a file at path on worker thread
+  /// @returns ENAMETOOLONG if path does not fit into arguments of a call
+  Fut<File, Error<AllocationError, SyscallError>>
+  open(Reactor &,
+       char const *path,
+       File::OpenFlags = File::OpenFlags::DEFAULT,
+       File::OpenPerms = File::OpenPerms::DEFAULT) noexcept;
+
+  /// @brief Flush file data and metadata to storage on worker thread
+  Fut<void, Error<AllocationError, SyscallError>> fsync(Reactor &, File const &) noexcept;
+
+  /// @brief Get status of file at path on worker thread
+  /// @returns ENAMETOOLONG if path does not fit into arguments of a call
+  Fut<void, Error<AllocationError, SyscallError>>
+  stat(Reactor &, char const *path, struct stat &out) noexcept;
+
+private:
+  enum class SlotState : uint32_t {
+    FREE,
+    /// Taken by a submitter which is filling call in
+    CLAIMED,
+    SUBMITTED,
+    DONE,
+    /// Future was dropped before DONE. Worker frees the slot once call returns
+    ABANDONED,
+  };
+
+  struct Slot {
+    std::atomic<SlotState> state = SlotState::FREE;
+    /// Call fields are written by submitter before SUBMITTED and read by worker after it. Call
+    /// may update args, which are read back by submitter after DONE
+    Call call = nullptr;
+    alignas(std::max_align_t) std::array<std::byte, MAX_ARGS_SIZE> args{};
+    /// Result fields are written by worker before DONE and read by submitter after it
+    long result = 0;
+    int error = 0;
+    os::Handle done_fd = -1;
+  };
+
+  static_assert(std::atomic<SlotState>::is_always_lock_free);
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "futex requires a plain 32-bit word");
+
+  static void *worker_main(void *self) noexcept;
+  void serve() noexcept;
+  void wake() noexcept;
+
+  std::array<Slot, MAX_PENDING> m_slots;
+  /// Bumped on each submission and on stop. Worker sleeps on it with futex
+  std::atomic<uint32_t> m_sequence = 0;
+  std::atomic<bool> m_stop = false;
+  pthread_t m_thread{};
+  bool m_running = false;
+};
+
+} // namespace corosig
+
+#endif
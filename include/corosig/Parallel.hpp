@@ -6,7 +6,7 @@
 #include "corosig/ErrorTypes.hpp"
 #include "corosig/Result.hpp"
 #include "corosig/Sleep.hpp"
-#include "corosig/container/Vector.hpp"
+#include "corosig/container/SmallVector.hpp"
 #include "corosig/meta/AResult.hpp"
 #include "corosig/meta/AnAwaitable.hpp"
 #include "corosig/reactor/Reactor.hpp"
@@ -119,6 +119,27 @@ when_all_succeed(Reactor &, AWAITABLE &&...awaitables) noexcept {
       std::move(results));
 }
 
+namespace detail {
+
+/// Suspend current coroutine and continue with target instead. Lets a child coroutine wake up a
+/// waiting one, which may destroy the child right away, since the child is already suspended
+struct TransferTo {
+  [[nodiscard]] static bool await_ready() noexcept {
+    return false;
+  }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept {
+    return target;
+  }
+
+  void await_resume() const noexcept {
+  }
+
+  std::coroutine_handle<> target;
+};
+
+} // namespace detail
+
 /// @brief Error type raised when a timeout is encountered
 struct TimedOutError {
   auto operator<=>(TimedOutError const &) const noexcept = default;
@@ -146,7 +167,7 @@ auto with_deadline(Reactor &r, AWAITABLE &&awaitable, SteadyClock::time_point de
                   co_await std::forward<AWAITABLE>(awaitable);
                   promise.m_result = std::monostate{};
                 }
-                promise.m_waiting_coro.resume();
+                co_await detail::TransferTo{promise.m_waiting_coro};
                 co_return Ok{};
               }(r, std::forward<AWAITABLE>(awaitable), *this),
 
@@ -156,7 +177,7 @@ auto with_deadline(Reactor &r, AWAITABLE &&awaitable, SteadyClock::time_point de
                 co_await Sleep{deadline};
                 if (promise.m_result.template holds<WithDeadlineAwaiter::NotReady>()) {
                   promise.m_result = TimedOutError{};
-                  promise.m_waiting_coro.resume();
+                  co_await detail::TransferTo{promise.m_waiting_coro};
                 }
                 co_return Ok{};
               }(r, deadline, *this),
@@ -235,7 +256,8 @@ template <std::ranges::range RANGE, typename LOOP_BODY>
 detail::parallel_foreach_return_type<RANGE, LOOP_BODY>
 parallel_foreach(Reactor &r, RANGE &&range, LOOP_BODY &&loop_body) noexcept {
   using Future = detail::parallel_foreach_return_type<RANGE, LOOP_BODY>;
-  Vector<Future> tasks{r.allocator()};
+  // most of the time there are just a few tasks, so try to keep them in the coroutine frame
+  SmallVector<Future, 8> tasks{r.allocator()};
   if constexpr (std::ranges::sized_range<RANGE>) {
     COROSIG_CO_TRYV(tasks.reserve(std::ranges::size(range)));
   }
@@ -1,22 +1,34 @@
 #ifndef COROSIG_SIGHANDLER_HPP
 #define COROSIG_SIGHANDLER_HPP
 
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
 #include "corosig/io/Stdio.hpp"
 #include "corosig/reactor/Reactor.hpp"
 
 #include <csignal>
+#include <cstddef>
 #include <cstdlib>
 #include <stdexcept>
 
+#if COROSIG_CALIBRATE_SIGHANDLERS
+#include "corosig/MemoryProfiler.hpp"
+
+#include <array>
+#include <string_view>
+
+#ifndef COROSIG_CALIBRATION_MEMORY
+#define COROSIG_CALIBRATION_MEMORY (static_cast<size_t>(16) * 1024 * 1024)
+#endif
+#endif
+
 namespace corosig {
 
 namespace detail {
 
-template <size_t MEMORY, auto F>
-void sighandler(int sig) noexcept {
-  std::signal(sig, SIG_DFL); // to avoid recursive call if something inside sighandler goes wrong
-  Allocator::Memory<MEMORY> mem;
-  Reactor reactor{mem};
+template <auto F>
+void run_sighandler(Reactor &reactor, int sig) noexcept {
   Result result = F(reactor, sig).block_on();
   if (!result.is_ok()) {
     (void)STDERR.write(reactor, "Unhandled error was returned from sighandler\n").block_on();
@@ -24,14 +36,81 @@ void sighandler(int sig) noexcept {
   (void)reactor.drain_remaining_tasks();
 }
 
+#if COROSIG_CALIBRATE_SIGHANDLERS
+
+/// Dry-run mode: the handler gets far more memory than it was configured with, and a report about
+/// what it has really used is printed afterwards
+template <size_t MEMORY, auto F>
+void sighandler(int sig) noexcept {
+  std::signal(sig, SIG_DFL);
+  static Allocator::Memory<COROSIG_CALIBRATION_MEMORY> mem;
+  static std::array<char, static_cast<size_t>(8 * 1024)> report_buf;
+
+  Reactor reactor{mem};
+  std::string_view report;
+  {
+    MemoryProfiler profiler{reactor.allocator()};
+    run_sighandler<F>(reactor, sig);
+    report = profiler.format_report(report_buf, MEMORY);
+  }
+  (void)STDERR.write(reactor, report).block_on();
+}
+
+#else
+
+template <size_t MEMORY, auto F>
+void sighandler(int sig) noexcept {
+  std::signal(sig, SIG_DFL); // to avoid recursive call if something inside sighandler goes wrong
+  Allocator::Memory<MEMORY> mem;
+  Reactor reactor{mem};
+  run_sighandler<F>(reactor, sig);
+}
+
+#endif
+
+/// Reactor and its memory are set up by install_sighandler ahead of time, so signal delivery goes
+/// straight to the first coroutine of F
+template <size_t MEMORY, auto F>
+struct PreparedSighandler {
+  static Reactor &reactor() noexcept {
+    static Allocator::Memory<MEMORY> mem;
+    static Reactor reactor{mem};
+    return reactor;
+  }
+
+  static void handle(int sig) noexcept {
+#if COROSIG_CALIBRATE_SIGHANDLERS
+    sighandler<MEMORY, F>(sig);
+#else
+    run_sighandler<F>(reactor(), sig);
+#endif
+  }
+};
+
+Result<void, SyscallError> install_sigaction(int sig, void (*handler)(int)) noexcept;
+
 } // namespace detail
 
+/// @brief Default size of an alternate stack set up by install_sighandler
+constexpr size_t DEFAULT_ALT_STACK_SIZE = size_t{64} * 1024;
+
+/// @brief Map an alternate signal stack with a guard page below it and set it for calling thread,
+///        unless the thread already has one. Handlers installed with SA_ONSTACK then run there, so
+///        even a stack overflow can be handled. Stack pages are touched right away, so they are
+///        resident before any signal arrives
+/// @note  Alternate stack is per thread. Threads created afterwards have none and must call this
+///        themselves
+Result<void, SyscallError> install_alt_stack(size_t size = DEFAULT_ALT_STACK_SIZE) noexcept;
+
 /// @brief  Sets a signal handler to work when sig is raised. This ensures there are no
 ///          recursive calls to the handler if something goes wrong inside. And also that all
 ///          unhandled errors from F are at least reported
 /// @note   There is nothing wrong to write your own signal handler. This function is here only to
 ///          save users some boilerplate and give idea about what may be good for them to do in the
 ///          start of sighandling
+/// @note   When compiled with COROSIG_CALIBRATE_SIGHANDLERS=1, the handler runs with
+///          COROSIG_CALIBRATION_MEMORY bytes instead of MEMORY and prints a report about its memory
+///          usage and a recommended MEMORY value to stderr. See calibrate.* targets in xmake.lua
 template <size_t MEMORY, auto F>
 void set_sighandler(int sig) {
   if (std::signal(sig, detail::sighandler<MEMORY, F>) == SIG_ERR) {
@@ -39,6 +118,20 @@ void set_sighandler(int sig) {
   }
 }
 
+/// @brief  Same as set_sighandler, but nothing is left to do at signal delivery. Handler is set
+///          with sigaction to run on an alternate stack, which is set up for calling thread if it
+///          has none. Reactor memory is static and Reactor itself, including its poll buffer, is
+///          constructed here. All other signals are blocked while handler runs and sig is reset to
+///          default action once delivered
+/// @note   Reactor is shared by every signal installed with the same MEMORY and F
+template <size_t MEMORY, auto F>
+Result<void, SyscallError>
+install_sighandler(int sig, size_t alt_stack_size = DEFAULT_ALT_STACK_SIZE) noexcept {
+  COROSIG_TRYV(install_alt_stack(alt_stack_size));
+  (void)detail::PreparedSighandler<MEMORY, F>::reactor();
+  return detail::install_sigaction(sig, &detail::PreparedSighandler<MEMORY, F>::handle);
+}
+
 } // namespace corosig
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef COROSIG_SIGNAL_STREAM_HPP
+#define COROSIG_SIGNAL_STREAM_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/util/SetDefaultOnMove.hpp"
+
+#include <csignal>
+#include <cstddef>
+#include <span>
+
+#ifdef __linux__
+#include <sys/signalfd.h>
+
+namespace corosig {
+
+/// @brief Signals delivered to an already running Reactor as data instead of to a handler. Suits
+///        non-fatal signals, like SIGHUP to reopen logs or SIGCHLD to reap children, which are
+///        then handled by an ordinary coroutine without any of sighandler restrictions
+/// @code
+/// COROSIG_TRY(auto stream, SignalStream::make(std::array{SIGHUP, SIGUSR1}));
+/// std::array<SignalStream::Info, 8> infos;
+/// COROSIG_CO_TRY(size_t n, co_await stream.read(r, infos));
+/// @endcode
+struct SignalStream {
+  using Info = signalfd_siginfo;
+
+  /// @brief Construct a SignalStream bound to invalid os::Handle
+  SignalStream() noexcept = default;
+
+  /// @brief Block given signals for calling thread and create a signalfd which receives them
+  /// @note Signals stay blocked only for the calling thread and threads created by it afterwards.
+  ///       Others must block them too, otherwise signals are delivered to them as usual
+  static Result<SignalStream, SyscallError> make(std::span<int const> signals) noexcept;
+
+  SignalStream(SignalStream const &) = delete;
+  SignalStream(SignalStream &&) noexcept = default;
+  SignalStream &operator=(SignalStream const &) = delete;
+  SignalStream &operator=(SignalStream &&rhs) noexcept {
+    if (this != &rhs) {
+      this->~SignalStream();
+      new (this) SignalStream{std::move(rhs)};
+    }
+    return *this;
+  }
+
+  ~SignalStream();
+
+  /// @brief Wait for at least one signal and read as many pending ones as fit into buffer. Pending
+  ///        signals are read right away without polling
+  /// @returns Number of signals read or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> read(Reactor &, std::span<Info>) noexcept;
+
+  /// @brief Read pending signals if there are any
+  /// @returns Number of signals read or EAGAIN if there are none
+  Result<size_t, SyscallError> try_read(std::span<Info>) noexcept;
+
+  /// @brief Close signalfd and unblock signals which were blocked by make. Signals still pending
+  ///        are then delivered as usual
+  void close() noexcept;
+
+  /// @brief Get OS-specific underlying handle
+  [[nodiscard]] os::Handle underlying_handle() const noexcept;
+
+private:
+  SetDefaultOnMove<int, -1> m_fd;
+  /// Signals which were not blocked before make
+  sigset_t m_unblock{};
+};
+
+} // namespace corosig
+
+#endif
+
+#endif
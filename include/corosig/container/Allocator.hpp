@@ -22,6 +22,21 @@ public:
     using std::array<char, SIZE - SIZE % BLOCK_SIZE>::array;
   };
 
+  /// @brief Receives notifications about allocations made through an Allocator. Used to profile
+  ///        memory usage, see corosig/MemoryProfiler.hpp
+  struct Observer {
+    /// @brief Called after each allocation attempt
+    /// @param ptr Allocated chunk or nullptr if an allocation has failed
+    /// @param call_site Return address of the allocate() call
+    virtual void on_allocate(void *ptr, size_t size, void const *call_site) noexcept = 0;
+
+    /// @brief Called before a chunk is returned to the allocator
+    virtual void on_deallocate(void *ptr) noexcept = 0;
+
+  protected:
+    ~Observer() = default;
+  };
+
   /// @brief Construct an Allocator for which allocations always fail
   Allocator() noexcept = default;
 
@@ -41,6 +56,16 @@ public:
   /// @brief Get the amount of currently used memory, in bytes
   [[nodiscard]] size_t current_memory() const noexcept;
 
+  /// @brief Get the size of underlying buffer available for allocations, in bytes
+  [[nodiscard]] size_t capacity() const noexcept;
+
+  /// @brief Tell if ptr points inside the buffer this allocator allocates from
+  [[nodiscard]] bool owns(void const *ptr) const noexcept;
+
+  /// @brief Attach an observer which is notified about every allocation and deallocation.
+  ///        Pass nullptr to detach current one
+  void set_observer(Observer *) noexcept;
+
   /// @brief Allocate a chunk of memory of specified size and alignment
   /// @returns A pointer to allocated buffer or nullptr if an allocation has failed
   /// @warning Is UB if alignment is not a power of 2
@@ -62,6 +87,7 @@ private:
     uint32_t next_free_block_idx = INVALID_IDX;
   };
 
+  void *allocate_impl(size_t size, size_t alignment) noexcept;
   void set_blocks_owned(size_t idx, uint32_t value) noexcept;
   size_t blocks_amount() const noexcept;
   size_t get_metadata_idx_from_addr(void *p) noexcept;
@@ -76,6 +102,7 @@ private:
   std::span<char> m_mem;
   size_t m_used = 0;
   size_t m_peak = 0;
+  Observer *m_observer = nullptr;
 };
 
 } // namespace corosig
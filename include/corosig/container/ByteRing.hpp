@@ -0,0 +1,193 @@
+#ifndef COROSIG_CONTAINER_BYTE_RING_HPP
+#define COROSIG_CONTAINER_BYTE_RING_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace corosig {
+
+/// @brief A fixed-capacity ring of bytes for streaming IO. Data is produced directly into
+///        writable() and made visible by commit(), consumed directly from readable() and dropped
+///        by consume(). No bytes are ever moved inside of the ring
+/// @code
+/// COROSIG_CO_TRY(auto ring, ByteRing::make(r.allocator(), 4096));
+/// COROSIG_CO_TRY(size_t n, co_await ring.fill_from(r, socket));
+/// parse(ring.readable());
+/// ring.consume(parsed);
+/// @endcode
+struct ByteRing {
+  /// @brief Make a ring which takes it's buffer from alloc. Capacity is rounded up to a power of
+  ///        two. When data wraps around the end of the buffer, readable() and writable() only
+  ///        return the part before the wrap point
+  static Result<ByteRing, AllocationError> make(Allocator &alloc, size_t min_capacity) noexcept;
+
+  /// @brief Make a mirrored ring, whose buffer is mapped twice back to back, so that
+  ///        readable() and writable() are always contiguous and contain all the data or all the
+  ///        free space respectively. Capacity is rounded up to a power of two which is not less
+  ///        than a page
+  /// @note Buffer is mapped with mmap, not taken from an allocator. Best made before a signal
+  ///       handler is installed and then reused. Available on Linux only, elsewhere fails with
+  ///       ENOSYS
+  static Result<ByteRing, SyscallError> make_mirrored(size_t min_capacity) noexcept;
+
+  ByteRing(ByteRing const &) = delete;
+  ByteRing(ByteRing &&) noexcept;
+  ByteRing &operator=(ByteRing const &) = delete;
+  ByteRing &operator=(ByteRing &&) noexcept;
+  ~ByteRing();
+
+  /// @brief Get a contiguous span of bytes which were committed and not yet consumed
+  [[nodiscard]] std::span<char const> readable() const noexcept {
+    size_t begin = m_head & mask();
+    size_t length = size();
+    if (!m_mirrored) {
+      length = std::min(length, m_capacity - begin);
+    }
+    return {m_data + begin, length};
+  }
+
+  /// @brief Get all readable bytes as up to two spans. Second one is non-empty only for a
+  ///        non-mirrored ring which has wrapped. Useful for vectored writes
+  [[nodiscard]] std::array<std::span<char const>, 2> readable_parts() const noexcept {
+    std::span<char const> first = readable();
+    return {first, std::span<char const>{m_data, size() - first.size()}};
+  }
+
+  /// @brief Get a contiguous span of free bytes to produce data into. Nothing written there is
+  ///        visible to readers until commit(). Span stays valid while data is consumed, so a
+  ///        producer may hold it across a suspension point
+  [[nodiscard]] std::span<char> writable() noexcept {
+    size_t begin = m_tail & mask();
+    size_t length = free_space();
+    if (!m_mirrored) {
+      length = std::min(length, m_capacity - begin);
+    }
+    return {m_data + begin, length};
+  }
+
+  /// @brief Get all free bytes as up to two spans. Second one is non-empty only for a
+  ///        non-mirrored ring which has wrapped. Useful for vectored reads
+  [[nodiscard]] std::array<std::span<char>, 2> writable_parts() noexcept {
+    std::span<char> first = writable();
+    return {first, std::span<char>{m_data, free_space() - first.size()}};
+  }
+
+  /// @brief Make n bytes written into writable() readable
+  void commit(size_t n) noexcept {
+    assert(n <= free_space() && "Commiting more than there is free space in ring");
+    m_tail += n;
+  }
+
+  /// @brief Drop n bytes from the beginning of readable()
+  void consume(size_t n) noexcept {
+    assert(n <= size() && "Consuming more than there is data in ring");
+    m_head += n;
+  }
+
+  /// @brief Drop all data and rewind, so whole buffer is writable in one piece
+  /// @warning Invalidates spans returned by writable() and writable_parts()
+  void clear() noexcept {
+    m_head = 0;
+    m_tail = 0;
+  }
+
+  /// @brief Get the amount of readable bytes
+  [[nodiscard]] size_t size() const noexcept {
+    return m_tail - m_head;
+  }
+
+  /// @brief Get the amount of writable bytes
+  [[nodiscard]] size_t free_space() const noexcept {
+    return m_capacity - size();
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return m_capacity;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  [[nodiscard]] bool full() const noexcept {
+    return size() == m_capacity;
+  }
+
+  /// @brief Tell if the ring was made with make_mirrored()
+  [[nodiscard]] bool is_mirrored() const noexcept {
+    return m_mirrored;
+  }
+
+  /// @brief Read once from reader, which is File, TcpSocket or alike, straight into writable()
+  ///        and commit what was read
+  /// @returns Amount of bytes read. Zero means an end of stream
+  /// @warning Ring must not be full
+  template <typename READER>
+  Fut<size_t, Error<AllocationError, SyscallError>> fill_from(Reactor &r,
+                                                              READER &reader) noexcept {
+    assert(!full() && "Filling a full ring");
+    COROSIG_CO_TRY(size_t n, co_await reader.read_some(r, writable()));
+    commit(n);
+    co_return n;
+  }
+
+  /// @brief Like fill_from, but does not wait for reader to become readable
+  template <typename READER>
+  Result<size_t, SyscallError> try_fill_from(READER &reader) noexcept {
+    assert(!full() && "Filling a full ring");
+    COROSIG_TRY(size_t n, reader.try_read_some(writable()));
+    commit(n);
+    return n;
+  }
+
+  /// @brief Write once into writer, which is File, TcpSocket or alike, straight from readable()
+  ///        and consume what was written
+  /// @returns Amount of bytes written
+  /// @warning Ring must not be empty
+  template <typename WRITER>
+  Fut<size_t, Error<AllocationError, SyscallError>> drain_to(Reactor &r,
+                                                             WRITER &writer) noexcept {
+    assert(!empty() && "Draining an empty ring");
+    COROSIG_CO_TRY(size_t n, co_await writer.write_some(r, readable()));
+    consume(n);
+    co_return n;
+  }
+
+  /// @brief Like drain_to, but does not wait for writer to become writable
+  template <typename WRITER>
+  Result<size_t, SyscallError> try_drain_to(WRITER &writer) noexcept {
+    assert(!empty() && "Draining an empty ring");
+    COROSIG_TRY(size_t n, writer.try_write_some(readable()));
+    consume(n);
+    return n;
+  }
+
+private:
+  ByteRing(char *data, size_t capacity, Allocator *alloc) noexcept;
+
+  [[nodiscard]] size_t mask() const noexcept {
+    return m_capacity - 1;
+  }
+
+  void release() noexcept;
+
+  char *m_data = nullptr;
+  size_t m_capacity = 0;
+  size_t m_head = 0;
+  size_t m_tail = 0;
+  Allocator *m_alloc = nullptr;
+  bool m_mirrored = false;
+};
+
+} // namespace corosig
+
+#endif
@@ -0,0 +1,508 @@
+#ifndef COROSIG_CONTAINER_FLAT_HASH_MAP_HPP
+#define COROSIG_CONTAINER_FLAT_HASH_MAP_HPP
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/meta/AnAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace corosig {
+
+namespace detail {
+
+/// Control byte of a slot. Full slots store 7 bits of element's hash, empty and deleted ones
+/// have the highest bit set
+enum class HashCtrl : int8_t {
+  EMPTY = -128,
+  DELETED = -2,
+};
+
+/// A group of control bytes which are matched simultaneously
+struct HashGroup {
+#if defined(__SSE2__)
+  constexpr static size_t WIDTH = 16;
+
+  explicit HashGroup(int8_t const *ctrl) noexcept
+      : m_ctrl{_mm_loadu_si128(reinterpret_cast<__m128i const *>(ctrl))} {
+  }
+
+  /// Bitmask of slots which have specified hash bits
+  [[nodiscard]] uint32_t match(int8_t h2) const noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+  }
+
+  /// Bitmask of empty slots
+  [[nodiscard]] uint32_t match_empty() const noexcept {
+    return match(static_cast<int8_t>(HashCtrl::EMPTY));
+  }
+
+  /// Bitmask of empty or deleted slots
+  [[nodiscard]] uint32_t match_free() const noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+  }
+
+private:
+  __m128i m_ctrl;
+#else
+  constexpr static size_t WIDTH = 8;
+
+  explicit HashGroup(int8_t const *ctrl) noexcept {
+    std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl));
+  }
+
+  [[nodiscard]] uint32_t match(int8_t h2) const noexcept {
+    // classic SWAR "has zero byte" trick. May report false positives after a true one, which is
+    // fine since every candidate is compared with the key anyway
+    uint64_t x = m_ctrl ^ (LSBS * static_cast<uint8_t>(h2));
+    return compress((x - LSBS) & ~x & MSBS);
+  }
+
+  [[nodiscard]] uint32_t match_empty() const noexcept {
+    // EMPTY is the only control value with the highest bit set and the second lowest one unset
+    return compress(m_ctrl & ~(m_ctrl << 6) & MSBS);
+  }
+
+  [[nodiscard]] uint32_t match_free() const noexcept {
+    return compress(m_ctrl & MSBS);
+  }
+
+private:
+  constexpr static uint64_t LSBS = 0x0101010101010101;
+  constexpr static uint64_t MSBS = 0x8080808080808080;
+
+  static uint32_t compress(uint64_t msbs) noexcept {
+    uint32_t result = 0;
+    for (size_t i = 0; msbs != 0; ++i, msbs >>= 8) {
+      result |= static_cast<uint32_t>(msbs & 0x80) >> (7 - i);
+    }
+    return result;
+  }
+
+  uint64_t m_ctrl;
+#endif
+};
+
+} // namespace detail
+
+/// @brief Open-addressing hash map in the spirit of Swiss tables: slots are probed in groups
+///        with SIMD comparisons of control bytes, so a lookup touches a couple of cache lines at
+///        most. Propagates all errors as values
+/// @note Iterators and references are invalidated by every insertion which causes a rehash
+/// @warning Keys of stored elements must not be modified through iterators
+template <typename K,
+          typename V,
+          typename HASH = std::hash<K>,
+          typename EQUAL = std::equal_to<K>,
+          AnAllocator ALLOCATOR = AllocatorRef<Allocator>>
+  requires std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V> &&
+           std::is_nothrow_move_constructible_v<ALLOCATOR>
+struct FlatHashMap {
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using size_type = size_t;
+  using hasher = HASH;
+  using key_equal = EQUAL;
+  using allocator_type = ALLOCATOR;
+
+private:
+  using Group = detail::HashGroup;
+  constexpr static size_t GROUP_WIDTH = Group::WIDTH;
+
+  template <typename MAP, typename VALUE>
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = VALUE *;
+    using reference = VALUE &;
+
+    Iterator() noexcept = default;
+
+    Iterator(MAP *map, size_t idx) noexcept
+        : m_map{map},
+          m_idx{idx} {
+      skip_free();
+    }
+
+    template <typename MAP2, typename VALUE2>
+      requires std::is_convertible_v<VALUE2 *, VALUE *>
+    Iterator(Iterator<MAP2, VALUE2> const &rhs) noexcept // NOLINT(google-explicit-constructor)
+        : m_map{rhs.m_map},
+          m_idx{rhs.m_idx} {
+    }
+
+    reference operator*() const noexcept {
+      return m_map->m_slots[m_idx];
+    }
+
+    pointer operator->() const noexcept {
+      return &m_map->m_slots[m_idx];
+    }
+
+    Iterator &operator++() noexcept {
+      ++m_idx;
+      skip_free();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(Iterator const &rhs) const noexcept {
+      return m_idx == rhs.m_idx;
+    }
+
+  private:
+    friend FlatHashMap;
+    template <typename, typename>
+    friend struct Iterator;
+
+    void skip_free() noexcept {
+      while (m_idx < m_map->m_capacity && m_map->m_ctrl[m_idx] < 0) {
+        ++m_idx;
+      }
+    }
+
+    MAP *m_map = nullptr;
+    size_t m_idx = 0;
+  };
+
+public:
+  using iterator = Iterator<FlatHashMap, value_type>;
+  using const_iterator = Iterator<FlatHashMap const, value_type const>;
+
+  /// @brief Make an empty map which uses alloc. Does not allocate
+  explicit FlatHashMap(ALLOCATOR &&alloc, HASH hash = HASH{}, EQUAL equal = EQUAL{}) noexcept
+      : m_alloc{std::move(alloc)},
+        m_hash{std::move(hash)},
+        m_equal{std::move(equal)} {
+  }
+
+  /// @brief Make an empty map which uses alloc. Does not allocate
+  explicit FlatHashMap(ALLOCATOR const &alloc, HASH hash = HASH{}, EQUAL equal = EQUAL{}) noexcept
+    requires std::is_copy_constructible_v<ALLOCATOR>
+      : m_alloc{alloc},
+        m_hash{std::move(hash)},
+        m_equal{std::move(equal)} {
+  }
+
+  FlatHashMap(FlatHashMap const &) = delete;
+  FlatHashMap &operator=(FlatHashMap const &) = delete;
+
+  FlatHashMap(FlatHashMap &&rhs) noexcept
+      : m_ctrl{std::exchange(rhs.m_ctrl, nullptr)},
+        m_slots{std::exchange(rhs.m_slots, nullptr)},
+        m_capacity{std::exchange(rhs.m_capacity, 0)},
+        m_size{std::exchange(rhs.m_size, 0)},
+        m_growth_left{std::exchange(rhs.m_growth_left, 0)},
+        m_alloc{rhs.m_alloc},
+        m_hash{rhs.m_hash},
+        m_equal{rhs.m_equal} {
+  }
+
+  FlatHashMap &operator=(FlatHashMap &&rhs) noexcept {
+    if (std::addressof(rhs) != this) {
+      this->~FlatHashMap();
+      new (this) FlatHashMap{std::move(rhs)};
+    }
+    return *this;
+  }
+
+  ~FlatHashMap() {
+    clear();
+    if (m_capacity != 0) {
+      m_alloc.deallocate(m_ctrl);
+    }
+  }
+
+  /// @brief Find an element with key equal to specified one
+  template <typename KEY>
+  [[nodiscard]] iterator find(KEY const &key) noexcept {
+    return iterator{this, find_index(key)};
+  }
+
+  /// @brief Find an element with key equal to specified one
+  template <typename KEY>
+  [[nodiscard]] const_iterator find(KEY const &key) const noexcept {
+    return const_iterator{this, find_index(key)};
+  }
+
+  /// @brief Tell if there is an element with key equal to specified one
+  template <typename KEY>
+  [[nodiscard]] bool contains(KEY const &key) const noexcept {
+    return find_index(key) != m_capacity;
+  }
+
+  /// @brief Insert an element constructed from key and args, if there is no element with key
+  ///        equal to specified one
+  /// @returns Iterator to the element with specified key and whether an insertion took place
+  template <typename... ARGS>
+  Result<std::pair<iterator, bool>, AllocationError> try_emplace(K key, ARGS &&...args) noexcept {
+    size_t hash = hash_of(key);
+    size_t idx = find_index(key, hash);
+    if (idx != m_capacity) {
+      return std::pair{iterator{this, idx}, false};
+    }
+
+    if (m_growth_left == 0) {
+      // when most of the used slots are tombstones, just clean them up
+      bool mostly_deleted = m_size * 2 < max_load(m_capacity);
+      COROSIG_TRYV(rehash(mostly_deleted ? m_capacity : std::max(GROUP_WIDTH, m_capacity * 2)));
+    }
+
+    idx = find_free_index(hash);
+    m_growth_left -= static_cast<size_t>(m_ctrl[idx] == static_cast<int8_t>(HashCtrl::EMPTY));
+    set_ctrl(idx, h2(hash));
+    new (m_slots + idx)
+        value_type{std::piecewise_construct,
+                   std::forward_as_tuple(std::move(key)),
+                   std::forward_as_tuple(std::forward<ARGS>(args)...)};
+    ++m_size;
+    return std::pair{iterator{this, idx}, true};
+  }
+
+  /// @brief Insert an element, if there is no element with equal key
+  /// @returns Iterator to the element with specified key and whether an insertion took place
+  Result<std::pair<iterator, bool>, AllocationError> insert(value_type &&value) noexcept {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+
+  /// @brief Insert an element or replace value of existing element with equal key
+  template <typename VALUE>
+  Result<iterator, AllocationError> insert_or_assign(K key, VALUE &&value) noexcept {
+    COROSIG_TRY(auto emplaced, try_emplace(std::move(key), std::forward<VALUE>(value)));
+    auto [it, inserted] = emplaced;
+    if (!inserted) {
+      it->second = std::forward<VALUE>(value);
+    }
+    return it;
+  }
+
+  /// @brief Remove an element which iterator points to
+  void erase(const_iterator pos) noexcept {
+    assert(pos.m_idx < m_capacity && m_ctrl[pos.m_idx] >= 0 && "Erasing invalid iterator");
+    size_t idx = pos.m_idx;
+    m_slots[idx].~value_type();
+    --m_size;
+
+    // if the group around the slot has never been full, no probe sequence went through it and
+    // the slot can become empty again instead of being a tombstone
+    size_t group_start = idx & ~(GROUP_WIDTH - 1);
+    if (Group{m_ctrl + group_start}.match_empty() != 0) {
+      set_ctrl(idx, static_cast<int8_t>(HashCtrl::EMPTY));
+      ++m_growth_left;
+    } else {
+      set_ctrl(idx, static_cast<int8_t>(HashCtrl::DELETED));
+    }
+  }
+
+  /// @brief Remove an element with key equal to specified one
+  /// @returns Amount of removed elements
+  template <typename KEY>
+  size_type erase(KEY const &key) noexcept {
+    size_t idx = find_index(key);
+    if (idx == m_capacity) {
+      return 0;
+    }
+    erase(const_iterator{this, idx});
+    return 1;
+  }
+
+  /// @brief Remove all the elements. Keeps allocated memory
+  void clear() noexcept {
+    if (m_capacity == 0) {
+      return;
+    }
+    for (size_t i = 0; i < m_capacity; ++i) {
+      if (m_ctrl[i] >= 0) {
+        m_slots[i].~value_type();
+      }
+    }
+    std::memset(m_ctrl, static_cast<int8_t>(HashCtrl::EMPTY), m_capacity);
+    m_size = 0;
+    m_growth_left = max_load(m_capacity);
+  }
+
+  /// @brief Make space for at least count elements without further rehashes
+  Result<void, AllocationError> reserve(size_type count) noexcept {
+    if (count <= m_size + m_growth_left) {
+      return Ok{};
+    }
+    size_t capacity = GROUP_WIDTH;
+    while (max_load(capacity) < count) {
+      capacity *= 2;
+    }
+    return rehash(capacity);
+  }
+
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator{this, 0};
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept {
+    return const_iterator{this, 0};
+  }
+
+  [[nodiscard]] iterator end() noexcept {
+    return iterator{this, m_capacity};
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept {
+    return const_iterator{this, m_capacity};
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return m_size == 0;
+  }
+
+  [[nodiscard]] size_type size() const noexcept {
+    return m_size;
+  }
+
+  /// @brief Get the amount of slots. Rehash happens when 7/8 of them become used
+  [[nodiscard]] size_type capacity() const noexcept {
+    return m_capacity;
+  }
+
+  [[nodiscard]] allocator_type &get_allocator() noexcept {
+    return m_alloc;
+  }
+
+private:
+  static size_t max_load(size_t capacity) noexcept {
+    return capacity - capacity / 8;
+  }
+
+  template <typename KEY>
+  size_t hash_of(KEY const &key) const noexcept {
+    // std::hash is often an identity function, so mix bits before using them
+    uint64_t hash = static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+
+  static int8_t h2(size_t hash) noexcept {
+    return static_cast<int8_t>(hash & 0x7F);
+  }
+
+  size_t groups_mask() const noexcept {
+    return m_capacity / GROUP_WIDTH - 1;
+  }
+
+  template <typename KEY>
+  size_t find_index(KEY const &key) const noexcept {
+    return find_index(key, hash_of(key));
+  }
+
+  template <typename KEY>
+  size_t find_index(KEY const &key, size_t hash) const noexcept {
+    if (m_capacity == 0) {
+      return m_capacity;
+    }
+
+    size_t group = (hash >> 7) & groups_mask();
+    for (size_t step = 1;; ++step) {
+      size_t group_start = group * GROUP_WIDTH;
+      Group g{m_ctrl + group_start};
+      for (uint32_t matches = g.match(h2(hash)); matches != 0; matches &= matches - 1) {
+        size_t idx = group_start + static_cast<size_t>(std::countr_zero(matches));
+        if (m_equal(m_slots[idx].first, key)) {
+          return idx;
+        }
+      }
+      if (g.match_empty() != 0 || step > groups_mask()) {
+        return m_capacity;
+      }
+      group = (group + step) & groups_mask();
+    }
+  }
+
+  size_t find_free_index(size_t hash) const noexcept {
+    size_t group = (hash >> 7) & groups_mask();
+    for (size_t step = 1;; ++step) {
+      size_t group_start = group * GROUP_WIDTH;
+      uint32_t free = Group{m_ctrl + group_start}.match_free();
+      if (free != 0) {
+        return group_start + static_cast<size_t>(std::countr_zero(free));
+      }
+      assert(step <= groups_mask() && "Hash map has no free slots");
+      group = (group + step) & groups_mask();
+    }
+  }
+
+  void set_ctrl(size_t idx, int8_t value) noexcept {
+    m_ctrl[idx] = value;
+  }
+
+  Result<void, AllocationError> rehash(size_t new_capacity) noexcept {
+    assert(std::has_single_bit(new_capacity) && new_capacity >= GROUP_WIDTH);
+
+    size_t slots_offset =
+        (new_capacity + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+    void *mem = m_alloc.allocate(slots_offset + new_capacity * sizeof(value_type),
+                                 std::max(alignof(value_type), GROUP_WIDTH));
+    if (mem == nullptr) {
+      return Failure{AllocationError{}};
+    }
+
+    FlatHashMap new_map{m_alloc, m_hash, m_equal};
+    new_map.m_ctrl = static_cast<int8_t *>(mem);
+    new_map.m_slots = reinterpret_cast<value_type *>(static_cast<char *>(mem) + slots_offset);
+    new_map.m_capacity = new_capacity;
+    std::memset(new_map.m_ctrl, static_cast<int8_t>(HashCtrl::EMPTY), new_capacity);
+    new_map.m_growth_left = max_load(new_capacity);
+
+    for (size_t i = 0; i < m_capacity; ++i) {
+      if (m_ctrl[i] < 0) {
+        continue;
+      }
+      size_t hash = hash_of(m_slots[i].first);
+      size_t idx = new_map.find_free_index(hash);
+      new_map.set_ctrl(idx, h2(hash));
+      new (new_map.m_slots + idx) value_type{std::move(m_slots[i])};
+      m_slots[i].~value_type();
+      m_ctrl[i] = static_cast<int8_t>(HashCtrl::DELETED);
+      --new_map.m_growth_left;
+      ++new_map.m_size;
+    }
+    m_size = 0;
+
+    *this = std::move(new_map);
+    return Ok{};
+  }
+
+  using HashCtrl = detail::HashCtrl;
+
+  int8_t *m_ctrl = nullptr;
+  value_type *m_slots = nullptr;
+  size_t m_capacity = 0;
+  size_t m_size = 0;
+  size_t m_growth_left = 0;
+  [[no_unique_address]] ALLOCATOR m_alloc;
+  [[no_unique_address]] HASH m_hash;
+  [[no_unique_address]] EQUAL m_equal;
+};
+
+} // namespace corosig
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef COROSIG_CONTAINER_LOG_QUEUE_HPP
+#define COROSIG_CONTAINER_LOG_QUEUE_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/BufWriter.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace corosig {
+
+/// @brief A bounded queue of log records in preallocated memory. Any amount of threads push
+///        records lock-free and without syscalls, while a single consumer, usually a signal
+///        handler, drains them. A record whose producer was interrupted mid-push, for example by
+///        that very signal, is detected and skipped instead of being read half-written
+/// @code
+/// LogQueue<1024> g_logs;
+/// // from any thread
+/// g_logs.push("request handled\n");
+/// // in a signal handler
+/// COROSIG_CO_TRYV(co_await g_logs.drain_to(r, file));
+/// @endcode
+template <size_t CAPACITY, size_t MAX_RECORD_SIZE = 256>
+struct LogQueue {
+  static_assert(std::has_single_bit(CAPACITY), "Capacity must be a power of two");
+  static_assert(MAX_RECORD_SIZE < (size_t{1} << 16), "Record size must fit into 16 bits");
+
+  /// @brief Space claimed for a single record by reserve
+  struct Reservation {
+    /// @brief Record has to be produced here
+    std::span<char, MAX_RECORD_SIZE> buffer;
+    size_t position;
+  };
+
+  LogQueue() noexcept {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+      m_cells[i].state.store(pack(i, 0), std::memory_order_relaxed);
+    }
+  }
+
+  LogQueue(LogQueue const &) = delete;
+  LogQueue(LogQueue &&) = delete;
+  LogQueue &operator=(LogQueue const &) = delete;
+  LogQueue &operator=(LogQueue &&) = delete;
+  ~LogQueue() = default;
+
+  /// @brief Claim space for a record, so it can be produced in place. Record is invisible to
+  ///        the consumer until commit
+  /// @returns std::nullopt if queue is full
+  /// @note Thread-safe and async-signal-safe
+  std::optional<Reservation> reserve() noexcept {
+    size_t position = m_enqueue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = m_cells[position & MASK];
+      uint64_t state = cell.state.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>((state & ~SIZE_MASK) - pack(position, 0));
+      if (diff == 0) {
+        if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          return Reservation{cell.data, position};
+        }
+      } else if (diff < 0) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+      } else {
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Make first size bytes of reserved buffer a record visible to the consumer
+  /// @returns false if the record was skipped as torn by the consumer meanwhile
+  /// @note Thread-safe and async-signal-safe
+  bool commit(Reservation const &reservation, size_t size) noexcept {
+    assert(size <= MAX_RECORD_SIZE && "Committing more than a record can hold");
+    // Size is published by the same CAS which checks ownership, so a producer whose record was
+    // skipped can't overwrite anything in a cell which is reused already
+    Cell &cell = m_cells[reservation.position & MASK];
+    uint64_t expected = pack(reservation.position, 0);
+    return cell.state.compare_exchange_strong(
+        expected, pack(reservation.position + 1, size), std::memory_order_release);
+  }
+
+  /// @brief Push a copy of record
+  /// @returns false if queue is full or record is longer than MAX_RECORD_SIZE
+  /// @note Thread-safe and async-signal-safe
+  bool push(std::span<char const> record) noexcept {
+    if (record.size() > MAX_RECORD_SIZE) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    std::optional reservation = reserve();
+    if (!reservation) {
+      return false;
+    }
+    std::memcpy(reservation->buffer.data(), record.data(), record.size());
+    return commit(*reservation, record.size());
+  }
+
+  /// @brief Push a copy of string literal, excluding null-terminator
+  template <size_t N>
+  bool push(char const (&arr)[N]) noexcept // NOLINT(modernize-avoid-c-arrays)
+  {
+    return push(std::string_view{arr});
+  }
+
+  /// @brief Get the oldest record
+  /// @returns std::nullopt if queue is empty or the oldest record is not committed yet
+  /// @note Must be called by the single consumer only
+  [[nodiscard]] std::optional<std::span<char const>> front() const noexcept {
+    return committed_at(m_dequeue);
+  }
+
+  /// @brief Drop the record returned by front and free its space for producers
+  /// @note Must be called by the single consumer only
+  void pop() noexcept {
+    assert(front().has_value() && "Popping a record which is not committed");
+    m_cells[m_dequeue & MASK].state.store(pack(m_dequeue + CAPACITY, 0), std::memory_order_release);
+    ++m_dequeue;
+  }
+
+  /// @brief Skip records at the front which were reserved but are not committed. In a signal
+  ///        handler those are ones whose producer was interrupted and will never commit
+  /// @returns Amount of skipped records
+  /// @warning A producer which is merely slow loses its record, and bytes it still copies into the
+  ///          reserved buffer may garble a record which reuses the cell. Don't call it in normal
+  ///          operation
+  /// @note Must be called by the single consumer only
+  size_t skip_torn() noexcept {
+    return skip_torn_before(m_enqueue.load(std::memory_order_acquire));
+  }
+
+  /// @brief Write records reserved before the call into writer, which is BufWriter, File,
+  ///        TcpSocket or alike. Committed records are written in batches, with a single vectored
+  ///        write if writer has a handle. Records which are still not committed when reached are
+  ///        skipped as torn. Records reserved after the call are left for the next drain, since
+  ///        their producers are running
+  /// @returns Amount of records written. On a failed write, records which got to writer as a
+  ///          whole are popped before the error is returned, while the record cut by the failure
+  ///          stays in the queue and is written again in full by the next drain
+  /// @note Must be called by the single consumer only. Meant for a signal handler, see skip_torn
+  template <typename WRITER>
+  Fut<size_t, Error<AllocationError, SyscallError>> drain_to(Reactor &r, WRITER &writer) noexcept {
+    size_t end = m_enqueue.load(std::memory_order_acquire);
+    size_t written = 0;
+    while (m_dequeue != end) {
+      std::array<std::span<char const>, DRAIN_BATCH> batch;
+      size_t count = 0;
+      while (count < batch.size() && m_dequeue + count != end) {
+        std::optional record = committed_at(m_dequeue + count);
+        if (!record) {
+          break;
+        }
+        batch[count++] = *record;
+      }
+      if (count == 0) {
+        // Fails if record got committed meanwhile, then it is taken by the next batch
+        (void)skip_torn_before(m_dequeue + 1);
+        continue;
+      }
+
+      auto records = std::span{batch}.first(count);
+      Result<void, Error<AllocationError, SyscallError>> res = Ok{};
+      size_t complete = 0;
+      if constexpr (detail::SinkWithHandle<WRITER>) {
+        size_t bytes = 0;
+        res = co_await detail::write_vectored(r, writer.underlying_handle(), records, bytes);
+        while (complete < count && records[complete].size() <= bytes) {
+          bytes -= records[complete].size();
+          ++complete;
+        }
+      } else {
+        for (; complete < count; ++complete) {
+          res = co_await writer.write(r, records[complete]);
+          if (!res) {
+            break;
+          }
+        }
+      }
+
+      // Records which got to writer as a whole must not be written again by the next drain
+      for (size_t i = 0; i < complete; ++i) {
+        pop();
+      }
+      written += complete;
+      COROSIG_CO_TRYV(std::move(res));
+    }
+    co_return written;
+  }
+
+  /// @brief Get amount of records which were lost because queue was full, they were too long or
+  ///        were skipped as torn
+  [[nodiscard]] size_t dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] constexpr size_t capacity() const noexcept {
+    return CAPACITY;
+  }
+
+private:
+  constexpr static size_t MASK = CAPACITY - 1;
+  constexpr static size_t DRAIN_BATCH = 16;
+  constexpr static uint64_t SIZE_MASK = (uint64_t{1} << 16) - 1;
+
+  struct Cell {
+    /// Sequence in upper bits and record size in lower 16 ones. Sequence equals position when
+    /// cell is free for it, position + 1 when committed
+    std::atomic<uint64_t> state;
+    std::array<char, MAX_RECORD_SIZE> data;
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  constexpr static uint64_t pack(size_t sequence, size_t size) noexcept {
+    return (static_cast<uint64_t>(sequence) << 16) | size;
+  }
+
+  [[nodiscard]] std::optional<std::span<char const>> committed_at(size_t position) const noexcept {
+    Cell const &cell = m_cells[position & MASK];
+    uint64_t state = cell.state.load(std::memory_order_acquire);
+    if ((state & ~SIZE_MASK) != pack(position + 1, 0)) {
+      return std::nullopt;
+    }
+    return std::span<char const>{cell.data.data(), static_cast<size_t>(state & SIZE_MASK)};
+  }
+
+  size_t skip_torn_before(size_t end) noexcept {
+    size_t skipped = 0;
+    while (m_dequeue != end) {
+      Cell &cell = m_cells[m_dequeue & MASK];
+      uint64_t expected = pack(m_dequeue, 0);
+      if (!cell.state.compare_exchange_strong(
+              expected, pack(m_dequeue + CAPACITY, 0), std::memory_order_acq_rel)) {
+        break;
+      }
+      ++m_dequeue;
+      ++skipped;
+    }
+    m_dropped.fetch_add(skipped, std::memory_order_relaxed);
+    return skipped;
+  }
+
+  std::array<Cell, CAPACITY> m_cells;
+  alignas(64) std::atomic<size_t> m_enqueue = 0;
+  std::atomic<size_t> m_dropped = 0;
+  alignas(64) size_t m_dequeue = 0;
+};
+
+} // namespace corosig
+
+#endif
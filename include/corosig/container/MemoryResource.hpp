@@ -0,0 +1,104 @@
+#ifndef COROSIG_CONTAINER_MEMORY_RESOURCE_HPP
+#define COROSIG_CONTAINER_MEMORY_RESOURCE_HPP
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/meta/AnAllocator.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace corosig {
+
+/// @brief What MemoryResource does when underlying allocator fails to allocate
+enum class OnAllocationFailure {
+  /// @brief Return nullptr. This breaks std::pmr::memory_resource contract, so use this only with
+  ///        code which checks results of allocate() or check failed() after such code is done
+  RETURN_NULLPTR,
+  /// @brief Throw std::bad_alloc as the standard demands
+  THROW_BAD_ALLOC,
+  /// @brief Call std::abort
+  ABORT,
+};
+
+/// @brief std::pmr::memory_resource which takes memory from corosig allocator, most often the one
+///        of a Reactor. Lets code which is written against std::pmr stay within handler's memory
+///        budget
+/// @code
+/// MemoryResource resource{r.allocator()};
+/// std::pmr::vector<int> ints{&resource};
+/// @endcode
+template <AnAllocator ALLOCATOR = AllocatorRef<Allocator>>
+struct MemoryResource final : std::pmr::memory_resource {
+  /// @brief Make a memory resource which allocates from alloc
+  explicit MemoryResource(ALLOCATOR alloc,
+                          OnAllocationFailure policy = OnAllocationFailure::RETURN_NULLPTR) noexcept
+      : m_alloc{std::move(alloc)},
+        m_policy{policy} {
+  }
+
+  MemoryResource(MemoryResource const &) = delete;
+  MemoryResource(MemoryResource &&) = delete;
+  MemoryResource &operator=(MemoryResource const &) = delete;
+  MemoryResource &operator=(MemoryResource &&) = delete;
+
+  ~MemoryResource() override = default;
+
+  /// @brief Get the amount of failed allocations
+  [[nodiscard]] size_t failed_allocations() const noexcept {
+    return m_failed_allocations;
+  }
+
+  /// @brief Tell if any allocation has failed. Check this after handing the resource to code
+  ///        which can't report failures itself
+  [[nodiscard]] bool failed() const noexcept {
+    return m_failed_allocations != 0;
+  }
+
+  [[nodiscard]] ALLOCATOR &get_allocator() noexcept {
+    return m_alloc;
+  }
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    void *result = m_alloc.allocate(bytes, alignment);
+    if (result != nullptr) [[likely]] {
+      return result;
+    }
+
+    ++m_failed_allocations;
+    switch (m_policy) {
+    case OnAllocationFailure::THROW_BAD_ALLOC:
+      throw std::bad_alloc{};
+    case OnAllocationFailure::ABORT:
+      std::abort();
+    case OnAllocationFailure::RETURN_NULLPTR:
+      break;
+    }
+    return nullptr;
+  }
+
+  void do_deallocate(void *ptr, size_t, size_t) override {
+    m_alloc.deallocate(ptr);
+  }
+
+  [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &rhs) const noexcept override {
+    return this == &rhs;
+  }
+
+  [[no_unique_address]] ALLOCATOR m_alloc;
+  OnAllocationFailure m_policy;
+  size_t m_failed_allocations = 0;
+};
+
+template <typename ALLOCATOR>
+MemoryResource(ALLOCATOR &) -> MemoryResource<AllocatorRef<ALLOCATOR>>;
+
+template <typename ALLOCATOR>
+MemoryResource(ALLOCATOR &, OnAllocationFailure) -> MemoryResource<AllocatorRef<ALLOCATOR>>;
+
+} // namespace corosig
+
+#endif
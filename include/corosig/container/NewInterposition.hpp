@@ -0,0 +1,135 @@
+#ifndef COROSIG_CONTAINER_NEW_INTERPOSITION_HPP
+#define COROSIG_CONTAINER_NEW_INTERPOSITION_HPP
+
+#include "corosig/container/Allocator.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace corosig {
+
+namespace detail {
+
+/// Allocate from active interposition or from global heap. Returns nullptr on failure
+void *interposed_new(size_t size, size_t alignment) noexcept;
+
+/// Allocate from active interposition or from global heap. Throws std::bad_alloc on failure
+void *interposed_new_or_throw(size_t size, size_t alignment);
+
+/// Return memory to the allocator it came from
+void interposed_delete(void *ptr) noexcept;
+
+} // namespace detail
+
+/// @brief While alive, redirects global operator new and delete on current thread into an
+///        Allocator, typically the one of a Reactor. This makes accidental heap usage inside a
+///        handler (by third-party code, std::format and alike) bounded by handler's memory budget
+///        and measurable
+/// @note Has effect only if COROSIG_DEFINE_GLOBAL_NEW_INTERPOSITION() is placed in exactly one
+///       translation unit of the program, since it's what replaces global operator new
+/// @warning Everything allocated while interposition is active must be freed before it ends.
+///          Allocations made before it started may be freed normally
+struct ScopedNewInterposition {
+  /// @brief Start redirecting allocations into alloc. Interpositions may be nested
+  explicit ScopedNewInterposition(Allocator &alloc) noexcept;
+
+  ScopedNewInterposition(ScopedNewInterposition const &) = delete;
+  ScopedNewInterposition(ScopedNewInterposition &&) = delete;
+  ScopedNewInterposition &operator=(ScopedNewInterposition const &) = delete;
+  ScopedNewInterposition &operator=(ScopedNewInterposition &&) = delete;
+
+  /// @brief Restore previous interposition or a regular global heap
+  ~ScopedNewInterposition();
+
+  /// @brief Get the amount of operator new calls redirected by this interposition
+  [[nodiscard]] size_t allocations() const noexcept;
+
+  /// @brief Get the amount of bytes requested by redirected operator new calls
+  [[nodiscard]] size_t allocated_bytes() const noexcept;
+
+  /// @brief Get the amount of redirected operator new calls which have failed
+  [[nodiscard]] size_t failed_allocations() const noexcept;
+
+private:
+  friend void *detail::interposed_new(size_t, size_t) noexcept;
+  friend void detail::interposed_delete(void *) noexcept;
+
+  Allocator &m_alloc;
+  ScopedNewInterposition *m_previous;
+  size_t m_allocations = 0;
+  size_t m_allocated_bytes = 0;
+  size_t m_failed_allocations = 0;
+};
+
+} // namespace corosig
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+/// @brief Replace global operator new and delete with ones which respect ScopedNewInterposition.
+///        Place it in exactly one translation unit at namespace scope
+#define COROSIG_DEFINE_GLOBAL_NEW_INTERPOSITION()                                                  \
+  void *operator new(std::size_t n) {                                                              \
+    return ::corosig::detail::interposed_new_or_throw(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);        \
+  }                                                                                                \
+  void *operator new[](std::size_t n) {                                                            \
+    return ::corosig::detail::interposed_new_or_throw(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);        \
+  }                                                                                                \
+  void *operator new(std::size_t n, std::align_val_t a) {                                          \
+    return ::corosig::detail::interposed_new_or_throw(n, static_cast<std::size_t>(a));             \
+  }                                                                                                \
+  void *operator new[](std::size_t n, std::align_val_t a) {                                        \
+    return ::corosig::detail::interposed_new_or_throw(n, static_cast<std::size_t>(a));             \
+  }                                                                                                \
+  void *operator new(std::size_t n, std::nothrow_t const &) noexcept {                             \
+    return ::corosig::detail::interposed_new(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);                 \
+  }                                                                                                \
+  void *operator new[](std::size_t n, std::nothrow_t const &) noexcept {                           \
+    return ::corosig::detail::interposed_new(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);                 \
+  }                                                                                                \
+  void *operator new(std::size_t n, std::align_val_t a, std::nothrow_t const &) noexcept {         \
+    return ::corosig::detail::interposed_new(n, static_cast<std::size_t>(a));                      \
+  }                                                                                                \
+  void *operator new[](std::size_t n, std::align_val_t a, std::nothrow_t const &) noexcept {       \
+    return ::corosig::detail::interposed_new(n, static_cast<std::size_t>(a));                      \
+  }                                                                                                \
+  void operator delete(void *p) noexcept {                                                         \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p) noexcept {                                                       \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete(void *p, std::size_t) noexcept {                                            \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p, std::size_t) noexcept {                                          \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete(void *p, std::align_val_t) noexcept {                                       \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p, std::align_val_t) noexcept {                                     \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete(void *p, std::size_t, std::align_val_t) noexcept {                          \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {                        \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete(void *p, std::nothrow_t const &) noexcept {                                 \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p, std::nothrow_t const &) noexcept {                               \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete(void *p, std::align_val_t, std::nothrow_t const &) noexcept {               \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  void operator delete[](void *p, std::align_val_t, std::nothrow_t const &) noexcept {             \
+    ::corosig::detail::interposed_delete(p);                                                       \
+  }                                                                                                \
+  static_assert(true)
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef COROSIG_CONTAINER_SMALL_VECTOR_HPP
+#define COROSIG_CONTAINER_SMALL_VECTOR_HPP
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/container/Vector.hpp"
+#include "corosig/meta/AnAllocator.hpp"
+#include "corosig/meta/Copyable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace corosig {
+
+/// @brief Vector which keeps up to N elements inline and only allocates when it grows beyond
+///        that. Has the same interface as Vector and propagates all errors as values
+/// @note Unlike Vector, moving a SmallVector which stores it's elements inline moves elements
+///       one by one, and thus invalidates iterators
+template <typename T, size_t N, AnAllocator ALLOCATOR = AllocatorRef<Allocator>>
+  requires std::is_nothrow_move_constructible_v<T> &&
+           std::is_nothrow_move_constructible_v<ALLOCATOR> && (N > 0)
+struct SmallVector {
+  using value_type = T;
+  using allocator_type = ALLOCATOR;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type &;
+  using const_reference = value_type const &;
+  using pointer = value_type *;
+  using const_pointer = value_type const *;
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /// @brief Amount of elements which are stored without allocations
+  constexpr static size_type INLINE_CAPACITY = N;
+
+public:
+  /// @brief Make a vector which uses alloc once inline storage is exhausted
+  explicit SmallVector(ALLOCATOR &&alloc) noexcept
+      : m_alloc{std::move(alloc)} {
+  }
+
+  /// @brief Make a vector which uses alloc once inline storage is exhausted
+  explicit SmallVector(ALLOCATOR const &alloc) noexcept
+    requires std::is_copy_constructible_v<ALLOCATOR>
+      : m_alloc{alloc} {
+  }
+
+  SmallVector(SmallVector const &) noexcept = delete;
+  SmallVector &operator=(SmallVector const &) = delete;
+
+  SmallVector(SmallVector &&rhs) noexcept
+      : m_alloc{rhs.m_alloc} {
+    if (rhs.is_inline()) {
+      for (auto i : std::views::iota(static_cast<size_type>(0), rhs.size())) {
+        new (inline_data() + i) value_type{std::move(rhs[i])};
+      }
+      m_size = rhs.m_size;
+      rhs.clear();
+    } else {
+      m_data = std::exchange(rhs.m_data, rhs.inline_data());
+      m_size = std::exchange(rhs.m_size, 0);
+      m_capacity = std::exchange(rhs.m_capacity, N);
+    }
+  }
+
+  SmallVector &operator=(SmallVector &&rhs) noexcept {
+    if (std::addressof(rhs) != this) {
+      this->~SmallVector();
+      new (this) SmallVector{std::move(rhs)};
+    }
+    return *this;
+  };
+
+  ~SmallVector() {
+    clear();
+    if (!is_inline()) {
+      m_alloc.deallocate(m_data);
+    }
+  }
+
+  constexpr auto clone() const noexcept
+    requires(Copyable<value_type>)
+  {
+    using Result =
+        detail::result_extended_with_clone_errors<value_type, SmallVector, AllocationError>;
+
+    SmallVector copies{m_alloc};
+    COROSIG_TRYTV(Result, copies.reserve(size()));
+    for (value_type const &value : *this) {
+      COROSIG_TRYT(Result, value_type cloned, corosig::clone(value));
+      COROSIG_TRYTV(Result, copies.push_back(std::move(cloned)));
+    }
+    return Result{std::move(copies)};
+  }
+
+  template <typename RANGE>
+    requires(std::ranges::range<RANGE> &&
+             std::same_as<value_type, std::ranges::range_value_t<RANGE>>)
+  constexpr Result<void, AllocationError> assign(RANGE &&values) noexcept {
+    using Result = detail::result_extended_with_clone_errors<value_type, void, AllocationError>;
+
+    SmallVector new_this{m_alloc};
+    if constexpr (std::ranges::sized_range<RANGE>) {
+      COROSIG_TRYTV(Result, new_this.reserve(std::ranges::size(values)));
+    }
+
+    for (auto &&value : values) {
+      COROSIG_TRYT(Result, value_type cloned, corosig::clone(std::forward<value_type>(value)));
+      COROSIG_TRYTV(Result, new_this.push_back(std::move(cloned)));
+    }
+
+    *this = std::move(new_this);
+    return Result{Ok{}};
+  }
+
+  constexpr void clear() noexcept {
+    while (!empty()) {
+      pop_back();
+    }
+  }
+
+  /// @brief Move elements back into inline storage if they fit there, or into an exactly-sized
+  ///        allocation otherwise
+  constexpr Result<void, AllocationError> shrink_to_fit() noexcept {
+    if (is_inline() || size() == capacity()) {
+      return Ok{};
+    }
+
+    pointer new_mem = inline_data();
+    if (size() > N) {
+      COROSIG_TRY(new_mem, allocate(size()));
+    }
+    relocate_to(new_mem, std::max(size(), N));
+    return Ok{};
+  }
+
+  constexpr Result<void, AllocationError> reserve(size_type count) noexcept {
+    if (count <= m_capacity) {
+      return Ok{};
+    }
+
+    COROSIG_TRY(pointer new_mem, allocate(count));
+    relocate_to(new_mem, count);
+    return Ok{};
+  }
+
+  constexpr auto resize(size_type count, value_type const &value = value_type{}) noexcept
+    requires(Copyable<value_type>)
+  {
+    using Result = detail::result_extended_with_clone_errors<value_type, void, AllocationError>;
+
+    while (count < size()) {
+      pop_back();
+    }
+
+    COROSIG_TRYTV(Result, reserve(count));
+    while (size() < count) {
+      COROSIG_TRYTV(Result, push_back(value));
+    }
+    return Result{Ok{}};
+  }
+
+  constexpr Result<void, AllocationError> resize_uninitialized(size_type count) noexcept {
+    while (count < size()) {
+      pop_back();
+    }
+
+    COROSIG_TRYV(reserve(count));
+    m_size = count;
+    return Ok{};
+  }
+
+  constexpr auto push_back(value_type const &value) noexcept
+    requires(Copyable<value_type>)
+  {
+    using Result = detail::result_extended_with_clone_errors<value_type, void, AllocationError>;
+    COROSIG_TRYT(Result, value_type cloned, corosig::clone(value));
+    return Result{push_back(std::move(cloned))};
+  }
+
+  constexpr Result<void, AllocationError> push_back(value_type &&value) noexcept {
+    if (size() == capacity()) {
+      COROSIG_TRYV(reserve(std::max<size_type>(N * 2, size() * 2)));
+    }
+    new (m_data + m_size) value_type{std::move(value)};
+    ++m_size;
+    return Ok{};
+  }
+
+  constexpr iterator erase(const_iterator pos) noexcept {
+    return erase(pos, pos + 1);
+  }
+
+  constexpr iterator erase(const_iterator first, const_iterator last) noexcept {
+    assert(last >= first);
+
+    size_type first_idx = first - begin();
+    size_type last_idx = last - begin();
+
+    std::move(begin() + last_idx, end(), begin() + first_idx);
+    for (size_type i = last_idx - first_idx; i > 0; --i) {
+      pop_back();
+    }
+    return begin() + first_idx;
+  }
+
+  constexpr Result<iterator, AllocationError> insert(const_iterator pos,
+                                                     value_type &&value) noexcept {
+    return insert(pos, std::span<value_type, 1>{std::addressof(value), 1});
+  }
+
+  template <typename RANGE>
+    requires(std::ranges::sized_range<RANGE> && !std::same_as<value_type, RANGE>)
+  constexpr Result<iterator, AllocationError> insert(const_iterator pos, RANGE &&values) noexcept {
+    size_type posi = pos - begin();
+    size_type count = std::ranges::size(values);
+    size_type old_size = size();
+
+    if (old_size + count > capacity()) {
+      COROSIG_TRYV(reserve(std::max(old_size + count, old_size * 2)));
+    }
+
+    for (size_type i = old_size; i > posi; --i) {
+      new (m_data + i - 1 + count) value_type{std::move(m_data[i - 1])};
+      m_data[i - 1].~value_type();
+    }
+
+    size_type i = posi;
+    for (auto &&value : values) {
+      new (m_data + i) value_type{std::move(value)};
+      ++i;
+    }
+
+    m_size = old_size + count;
+    return begin() + posi;
+  }
+
+  constexpr void pop_back() noexcept {
+    value_type &last = back();
+    last.~value_type();
+    --m_size;
+  }
+
+  constexpr reference operator[](size_type i) noexcept {
+    assert(i < size() && "Out of bounds access into vector");
+    return *(begin() + i);
+  }
+
+  constexpr const_reference operator[](size_type i) const noexcept {
+    assert(i < size() && "Out of bounds access into vector");
+    return *(begin() + i);
+  }
+
+  constexpr reference front() noexcept {
+    assert(!empty() && "front() access on empty vector");
+    return *begin();
+  }
+
+  constexpr const_reference front() const noexcept {
+    assert(!empty() && "front() access on empty vector");
+    return *begin();
+  }
+
+  constexpr reference back() noexcept {
+    assert(!empty() && "back() access on empty vector");
+    return *(end() - 1);
+  }
+
+  constexpr const_reference back() const noexcept {
+    assert(!empty() && "back() access on empty vector");
+    return *(end() - 1);
+  }
+
+  constexpr pointer data() noexcept {
+    return m_data;
+  }
+
+  constexpr const_pointer data() const noexcept {
+    return m_data;
+  }
+
+  constexpr iterator begin() noexcept {
+    return m_data;
+  }
+
+  constexpr const_iterator begin() const noexcept {
+    return m_data;
+  }
+
+  constexpr iterator end() noexcept {
+    return m_data + size();
+  }
+
+  constexpr const_iterator end() const noexcept {
+    return m_data + size();
+  }
+
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return m_size == 0;
+  }
+
+  [[nodiscard]] constexpr size_type size() const noexcept {
+    return m_size;
+  }
+
+  [[nodiscard]] constexpr size_type capacity() const noexcept {
+    return m_capacity;
+  }
+
+  /// @brief Tell if elements are currently kept in inline storage
+  [[nodiscard]] constexpr bool is_inline() const noexcept {
+    return m_data == inline_data();
+  }
+
+  [[nodiscard]] constexpr static size_type max_size() noexcept {
+    return std::numeric_limits<size_type>::max();
+  }
+
+  [[nodiscard]] constexpr allocator_type &get_allocator() noexcept {
+    return m_alloc;
+  }
+
+private:
+  Result<pointer, AllocationError> allocate(size_type count) noexcept {
+    auto new_mem =
+        static_cast<pointer>(m_alloc.allocate(count * sizeof(value_type), alignof(value_type)));
+    if (new_mem == nullptr) {
+      return Failure{AllocationError{}};
+    }
+    return new_mem;
+  }
+
+  void relocate_to(pointer new_mem, size_type new_capacity) noexcept {
+    for (auto i : std::views::iota(static_cast<size_type>(0), size())) {
+      new (new_mem + i) value_type{std::move(m_data[i])};
+      m_data[i].~value_type();
+    }
+
+    if (!is_inline()) {
+      m_alloc.deallocate(m_data);
+    }
+    m_data = new_mem;
+    m_capacity = new_capacity;
+  }
+
+  pointer inline_data() noexcept {
+    return reinterpret_cast<pointer>(m_inline.data());
+  }
+
+  const_pointer inline_data() const noexcept {
+    return reinterpret_cast<const_pointer>(m_inline.data());
+  }
+
+  alignas(value_type) std::array<std::byte, sizeof(value_type) * N> m_inline;
+  value_type *m_data = inline_data();
+  size_type m_size = 0;
+  size_type m_capacity = N;
+  [[no_unique_address]] ALLOCATOR m_alloc;
+};
+
+} // namespace corosig
+
+#endif
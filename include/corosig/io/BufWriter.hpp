@@ -0,0 +1,265 @@
+#ifndef COROSIG_IO_BUF_WRITER_HPP
+#define COROSIG_IO_BUF_WRITER_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/container/Vector.hpp"
+#include "corosig/meta/AnAllocator.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace corosig {
+
+namespace detail {
+
+template <typename SINK>
+concept BufWriterSink = requires(SINK &sink, Reactor &r, std::span<char const> buf) {
+  { sink.write(r, buf) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+};
+
+template <typename SINK>
+concept SinkWithHandle = requires(SINK const &sink) {
+  { sink.underlying_handle() } -> std::convertible_to<os::Handle>;
+};
+
+/// Write all bytes of all buffers into handle with a single vectored write when possible. Amount
+/// written by each syscall is added to written right after it, so it stays exact if an error is
+/// returned or the future is dropped midway
+Fut<void, Error<AllocationError, SyscallError>>
+write_vectored(Reactor &,
+               os::Handle,
+               std::span<std::span<char const> const>,
+               size_t &written) noexcept;
+
+} // namespace detail
+
+/// @brief Buffered writer over File, TcpSocket, PipeWrite, StdOut or alike. Coalesces small writes
+///        in a buffer and writes them into sink once buffer is full or on flush(). Writes which
+///        are larger than the buffer go to sink directly, together with already buffered bytes in
+///        one vectored write
+/// @code
+/// BufWriter out{StdOut::stderr(), r.allocator()};
+/// COROSIG_CO_TRYV(co_await out.write(r, "crashed at "));
+/// std::format_to(out.out(), "{:#x}\n", address);
+/// COROSIG_CO_TRYV(co_await out.flush(r));
+/// @endcode
+/// @warning Destructor does not flush. Bytes which were not flushed are lost
+template <detail::BufWriterSink SINK, AnAllocator ALLOCATOR = AllocatorRef<Allocator>>
+struct BufWriter {
+  /// @brief Default capacity of the buffer
+  constexpr static size_t DEFAULT_CAPACITY = 4096;
+
+  /// @brief Output iterator for std::format_to and alike. Appends into buffer, growing it past
+  ///        capacity if needed, since it can't flush. If buffer can't grow, failure is reported by
+  ///        the next flush()
+  struct OutputIterator {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    OutputIterator &operator*() noexcept {
+      return *this;
+    }
+
+    OutputIterator &operator++() noexcept {
+      return *this;
+    }
+
+    OutputIterator &operator++(int) noexcept {
+      return *this;
+    }
+
+    OutputIterator &operator=(char c) noexcept {
+      m_writer->put(c);
+      return *this;
+    }
+
+    BufWriter *m_writer;
+  };
+
+  /// @brief Make a writer into sink with buffer of specified capacity taken from alloc. Nothing is
+  ///        allocated until the first write
+  BufWriter(SINK sink, ALLOCATOR alloc, size_t capacity = DEFAULT_CAPACITY) noexcept
+      : m_sink{std::move(sink)},
+        m_buffer{std::move(alloc)},
+        m_capacity{capacity} {
+  }
+
+  BufWriter(BufWriter const &) = delete;
+  BufWriter(BufWriter &&) noexcept = default;
+  BufWriter &operator=(BufWriter const &) = delete;
+  BufWriter &operator=(BufWriter &&) noexcept = default;
+  ~BufWriter() = default;
+
+  /// @brief Write all bytes from data. Completes without suspending if data fits into buffer
+  Fut<void, Error<AllocationError, SyscallError>> write(Reactor &r,
+                                                        std::span<char const> data) noexcept {
+    using Future = Fut<void, Error<AllocationError, SyscallError>>;
+
+    if (m_buffer.size() + data.size() <= m_capacity) {
+      if (!append(data)) {
+        return Future::make_ready(Failure{AllocationError{}});
+      }
+      return Future::make_ready(Ok{});
+    }
+    return write_slow(r, data);
+  }
+
+  /// @brief Write all bytes from string literal, excluding null-terminator
+  template <size_t N>
+  Fut<void, Error<AllocationError, SyscallError>>
+  write(Reactor &r,
+        char const (&arr)[N]) noexcept // NOLINT(modernize-avoid-c-arrays)
+  {
+    return write(r, std::string_view{arr});
+  }
+
+  /// @brief Write all buffered bytes into sink
+  /// @returns Error of the sink, in which case bytes it has taken are dropped from the buffer and
+  ///          the rest stay buffered. AllocationError if OutputIterator has failed to grow the
+  ///          buffer since last flush. Bytes which did fit are written anyway
+  Fut<void, Error<AllocationError, SyscallError>> flush(Reactor &r) noexcept {
+    if (!m_buffer.empty()) {
+      COROSIG_CO_TRYV(co_await write_all(r, buffered(), {}));
+    }
+    if (std::exchange(m_failed, false)) {
+      co_return Failure{AllocationError{}};
+    }
+    co_return Ok{};
+  }
+
+  /// @brief Get an output iterator which appends into this writer
+  OutputIterator out() noexcept {
+    return OutputIterator{this};
+  }
+
+  /// @brief Get bytes which are buffered and not yet written into sink
+  [[nodiscard]] std::span<char const> buffered() const noexcept {
+    return {m_buffer.data(), m_buffer.size()};
+  }
+
+  /// @brief Tell if OutputIterator has failed to grow the buffer since last flush. The failure is
+  ///        reported by the next flush
+  [[nodiscard]] bool failed() const noexcept {
+    return m_failed;
+  }
+
+  /// @brief Get the amount of bytes after which writes are flushed
+  [[nodiscard]] size_t capacity() const noexcept {
+    return m_capacity;
+  }
+
+  [[nodiscard]] SINK &sink() noexcept {
+    return m_sink;
+  }
+
+  [[nodiscard]] SINK const &sink() const noexcept {
+    return m_sink;
+  }
+
+private:
+  Fut<void, Error<AllocationError, SyscallError>> write_slow(Reactor &r,
+                                                             std::span<char const> data) noexcept {
+    if (data.size() >= m_capacity) {
+      // copying large data into buffer only to write it right away is a waste
+      COROSIG_CO_TRYV(co_await write_all(r, buffered(), data));
+      co_return Ok{};
+    }
+
+    COROSIG_CO_TRYV(co_await write_all(r, buffered(), {}));
+    if (!append(data)) {
+      co_return Failure{AllocationError{}};
+    }
+    co_return Ok{};
+  }
+
+  /// Write head, which is the whole buffer, and then tail. Bytes of head which were written are
+  /// dropped from the buffer, even if an error is returned
+  Fut<void, Error<AllocationError, SyscallError>>
+  write_all(Reactor &r, std::span<char const> head, std::span<char const> tail) noexcept {
+    size_t written = 0;
+    Result<void, Error<AllocationError, SyscallError>> res = Ok{};
+    if constexpr (detail::SinkWithHandle<SINK>) {
+      std::array<std::span<char const>, 2> bufs{head, tail};
+      res = co_await detail::write_vectored(r, m_sink.underlying_handle(), bufs, written);
+    } else {
+      res = co_await write_each(r, head, tail, written);
+    }
+    m_buffer.erase(m_buffer.begin(),
+                   m_buffer.begin() + static_cast<std::ptrdiff_t>(std::min(written, head.size())));
+    co_return res;
+  }
+
+  /// Sinks report an error only if nothing was written, so a short write is retried to get it
+  Fut<void, Error<AllocationError, SyscallError>> write_each(Reactor &r,
+                                                             std::span<char const> head,
+                                                             std::span<char const> tail,
+                                                             size_t &written) noexcept {
+    for (std::span<char const> buf : {head, tail}) {
+      while (!buf.empty()) {
+        COROSIG_CO_TRY(size_t n, co_await m_sink.write(r, buf));
+        if (n == 0) {
+          co_return Failure{SyscallError{EIO}};
+        }
+        written += n;
+        buf = buf.subspan(n);
+      }
+    }
+    co_return Ok{};
+  }
+
+  bool append(std::span<char const> data) noexcept {
+    if (m_buffer.capacity() < m_capacity && !m_buffer.reserve(m_capacity)) {
+      return false;
+    }
+    size_t old_size = m_buffer.size();
+    if (!m_buffer.resize_uninitialized(old_size + data.size())) {
+      return false;
+    }
+    std::memcpy(m_buffer.data() + old_size, data.data(), data.size());
+    return true;
+  }
+
+  void put(char c) noexcept {
+    if (m_failed) {
+      return;
+    }
+    if (m_buffer.capacity() < m_capacity && !m_buffer.reserve(m_capacity)) {
+      m_failed = true;
+      return;
+    }
+    if (!m_buffer.push_back(char{c})) {
+      m_failed = true;
+    }
+  }
+
+  SINK m_sink;
+  Vector<char, ALLOCATOR> m_buffer;
+  size_t m_capacity;
+  bool m_failed = false;
+};
+
+template <typename SINK, typename ALLOCATOR>
+BufWriter(SINK, ALLOCATOR &) -> BufWriter<SINK, AllocatorRef<ALLOCATOR>>;
+
+template <typename SINK, typename ALLOCATOR>
+BufWriter(SINK, ALLOCATOR &, size_t) -> BufWriter<SINK, AllocatorRef<ALLOCATOR>>;
+
+} // namespace corosig
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef COROSIG_IO_COPY_HPP
+#define COROSIG_IO_COPY_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/container/Vector.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/meta/AsyncIo.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace corosig {
+
+/// @brief Default amount of reactor memory copy may use for buffers
+constexpr size_t DEFAULT_COPY_BUDGET = 4096;
+
+/// @brief Copy everything from reader to writer until reader ends. Buffer budget is split in two
+///        halves, so that one of them is being filled while the other one is being drained
+/// @returns Amount of bytes copied or the first error met
+template <AsyncRead READER, AsyncWrite WRITER>
+Fut<size_t, Error<AllocationError, SyscallError>>
+copy(Reactor &r,
+     READER &reader,
+     WRITER &writer,
+     size_t buffer_budget = DEFAULT_COPY_BUDGET) noexcept {
+  Vector<char> buffer{r.allocator()};
+  COROSIG_CO_TRYV(buffer.resize_uninitialized(std::max<size_t>(buffer_budget, 2)));
+  size_t half = buffer.size() / 2;
+  std::span<char> front{buffer.data(), half};
+  std::span<char> back{buffer.data() + half, half};
+
+  size_t copied = 0;
+  COROSIG_CO_TRY(size_t filled, co_await reader.read_some(r, front));
+  while (filled != 0) {
+    // futures start right away, so the write is in flight while the next read waits
+    auto writing = writer.write(r, front.first(filled));
+    auto next = co_await reader.read_some(r, back);
+
+    COROSIG_CO_TRY(size_t written, co_await std::move(writing));
+    // writer reports an error only if nothing was written, so a short write is retried to get it
+    while (written != filled) {
+      COROSIG_CO_TRY(size_t n, co_await writer.write(r, front.subspan(written, filled - written)));
+      if (n == 0) {
+        co_return Failure{SyscallError{EIO}};
+      }
+      written += n;
+    }
+    copied += written;
+    COROSIG_CO_TRY(filled, std::move(next));
+    std::swap(front, back);
+  }
+  co_return copied;
+}
+
+/// @brief Copy rest of the file starting at its offset into socket with sendfile, so data does
+///        not pass through userspace. Falls back to buffered copy if sendfile is not supported
+///        for these ends. File's offset is moved past copied data, even if an error is returned
+///        after some of it was sent
+/// @returns Amount of bytes copied or the first error met
+Fut<size_t, Error<AllocationError, SyscallError>>
+copy(Reactor &, File &, TcpSocket &, size_t buffer_budget = DEFAULT_COPY_BUDGET) noexcept;
+
+/// @brief Copy everything from one pipe into another with splice, so data does not pass through
+///        userspace. Falls back to buffered copy if splice is not supported
+/// @returns Amount of bytes copied or the first error met
+Fut<size_t, Error<AllocationError, SyscallError>>
+copy(Reactor &, PipeRead &, PipeWrite &, size_t buffer_budget = DEFAULT_COPY_BUDGET) noexcept;
+
+} // namespace corosig
+
+#endif
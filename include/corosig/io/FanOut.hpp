@@ -0,0 +1,174 @@
+#ifndef COROSIG_IO_FAN_OUT_HPP
+#define COROSIG_IO_FAN_OUT_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Parallel.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/BufWriter.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/UdpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+namespace corosig {
+
+/// @brief What to do with a sink of fan_out which is failing or is too slow
+struct FanOutPolicy {
+  /// @brief Give up on the sink if it has not taken the whole source in time. Zero means no limit
+  std::chrono::milliseconds timeout{0};
+
+  /// @brief Make fan_out fail if the sink fails. Otherwise the sink is just dropped and others
+  ///        go on
+  bool required = false;
+};
+
+/// @brief One of sinks fan_out writes into, together with its own progress
+template <typename SINK>
+struct FanOutSink {
+  SINK &sink;
+  FanOutPolicy policy = {};
+
+  /// @brief Where to send datagrams if sink is UdpSocket or alike. Each chunk of the source is
+  ///        sent as a separate datagram, split into several ones if it is longer than
+  ///        UdpSocket::MAX_PAYLOAD_SIZE
+  SockaddrStorage const *destination = nullptr;
+
+  /// @brief Amount of source bytes the sink has taken so far
+  size_t progress = 0;
+
+  /// @brief Why the sink was dropped, if it was
+  Result<void, Error<AllocationError, SyscallError, TimedOutError>> result = Ok{};
+};
+
+template <typename SINK>
+FanOutSink(SINK &, FanOutPolicy = {}, SockaddrStorage const * = nullptr) -> FanOutSink<SINK>;
+
+namespace detail {
+
+template <typename SINK>
+concept DatagramSink = requires(SINK &sink, Reactor &r, std::span<OutgoingDatagram const> batch) {
+  { sink.send_batch(r, batch) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+};
+
+/// Maximum amount of chunks written into a stream sink at once
+constexpr size_t FAN_OUT_MAX_CHUNKS = 16;
+
+/// Skip first skip bytes of source and put up to out.size() non-empty chunks of what is left into
+/// out. Returns the amount of chunks put
+size_t gather_chunks(std::span<std::span<char const> const> source,
+                     size_t skip,
+                     std::span<std::span<char const>> out) noexcept;
+
+/// Write source into sink starting from its progress, using the best batching sink has
+template <typename SINK>
+Fut<void, Error<AllocationError, SyscallError>>
+deliver(Reactor &r,
+        FanOutSink<SINK> &target,
+        std::span<std::span<char const> const> source) noexcept {
+  std::array<std::span<char const>, FAN_OUT_MAX_CHUNKS> chunks;
+  while (size_t count = gather_chunks(source, target.progress, chunks)) {
+    if constexpr (DatagramSink<SINK>) {
+      assert(target.destination != nullptr && "Datagram sink requires a destination");
+      std::array<OutgoingDatagram, FAN_OUT_MAX_CHUNKS> batch;
+      size_t datagrams = 0;
+      for (std::span<char const> chunk : std::span{chunks}.first(count)) {
+        while (!chunk.empty() && datagrams < batch.size()) {
+          size_t size = std::min(chunk.size(), UdpSocket::MAX_PAYLOAD_SIZE);
+          batch[datagrams++] =
+              OutgoingDatagram{.data = chunk.first(size), .dest = target.destination};
+          chunk = chunk.subspan(size);
+        }
+      }
+      COROSIG_CO_TRY(size_t sent,
+                     co_await target.sink.send_batch(r, std::span{batch}.first(datagrams)));
+      for (OutgoingDatagram const &datagram : std::span{batch}.first(sent)) {
+        target.progress += datagram.data.size();
+      }
+    } else if constexpr (SinkWithHandle<SINK>) {
+      // progress is moved by each syscall, so it stays exact when a timeout drops this future
+      COROSIG_CO_TRYV(co_await write_vectored(
+          r, target.sink.underlying_handle(), std::span{chunks}.first(count), target.progress));
+    } else {
+      COROSIG_CO_TRY(size_t written, co_await target.sink.write(r, chunks[0]));
+      target.progress += written;
+    }
+  }
+  co_return Ok{};
+}
+
+/// Deliver source into target and put the outcome into its result. The result is set only once
+/// delivery is over, so it is left untouched if this frame could not be allocated
+template <typename SINK>
+Fut<void, AllocationError>
+deliver_with_policy(Reactor &r,
+                    FanOutSink<SINK> &target,
+                    std::span<std::span<char const> const> source) noexcept {
+  if (target.policy.timeout == std::chrono::milliseconds{0}) {
+    auto delivered = co_await deliver(r, target, source);
+    if (delivered) {
+      target.result = Ok{};
+    } else {
+      target.result = Failure{std::move(delivered.error())};
+    }
+    co_return Ok{};
+  }
+
+  auto delivered = co_await with_deadline(r, deliver(r, target, source), target.policy.timeout);
+  if (!delivered) {
+    target.result = Failure{std::move(delivered.error())};
+  } else if (!delivered.value()) {
+    target.result = Failure{std::move(delivered.value().error())};
+  } else {
+    target.result = Ok{};
+  }
+  co_return Ok{};
+}
+
+} // namespace detail
+
+/// @brief Write the same source into all sinks concurrently. Each sink goes at its own pace with
+///        its own progress, so a slow one never holds the others back. Stream sinks, such as File,
+///        TcpSocket or StdOut, get vectored writes, while datagram sinks, such as UdpSocket, get
+///        each chunk of source as a datagram in batches
+/// @param source Chunks of data, for example a single buffer or readable_parts() of a ring
+/// @returns Failure of the first required sink which has failed, including failing to allocate
+///          its delivery. Failures of other sinks are only reported in their result
+/// @code
+/// FanOutSink to_file{file};
+/// FanOutSink to_server{udp, {.timeout = 100ms}, &server_addr};
+/// COROSIG_CO_TRYV(co_await fan_out(r, ring.readable_parts(), to_file, to_server));
+/// @endcode
+template <typename... SINKS>
+Fut<void, Error<AllocationError, SyscallError, TimedOutError>>
+fan_out(Reactor &r,
+        std::span<std::span<char const> const> source,
+        FanOutSink<SINKS> &...sinks) noexcept {
+  // A sink keeps this failure if its delivery could not be allocated, or if it was cut short
+  // because the futures waiting for it could not be
+  ((sinks.result = Failure{AllocationError{}}), ...);
+  [[maybe_unused]] auto delivered =
+      co_await when_all_succeed(r, detail::deliver_with_policy(r, sinks, source)...);
+  assert((delivered || (!sinks.result.is_ok() || ...)) && "Failed delivery is not in any result");
+
+  Result<void, Error<AllocationError, SyscallError, TimedOutError>> result = Ok{};
+  auto take_failure = [&](auto const &target) {
+    if (result.is_ok() && target.policy.required && !target.result.is_ok()) {
+      result = target.result;
+    }
+  };
+  (take_failure(sinks), ...);
+  co_return result;
+}
+
+} // namespace corosig
+
+#endif
@@ -10,6 +10,7 @@
 #include "corosig/util/SetDefaultOnMove.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <fcntl.h>
 #include <span>
 
@@ -38,6 +39,9 @@ public:
     /// @brief Open file in read only mode
     RDONLY = O_RDONLY,
 
+    /// @brief Open file for both reading and writing
+    RDWR = O_RDWR,
+
     DEFAULT = RDONLY,
   };
 
@@ -67,6 +71,24 @@ public:
     DEFAULT = READ | WRITE | GRP_READ | OTH_READ,
   };
 
+  /// @brief What is done to make written data durable when file is synced or closed
+  enum class Durability : uint8_t {
+    /// @brief Nothing. Data reaches storage whenever kernel decides to
+    NONE,
+
+    /// @brief Start writeback of dirty pages without waiting for it (sync_file_range). Linux
+    ///        only, same as NONE elsewhere
+    WRITE_BEHIND,
+
+    /// @brief Wait until data and metadata required to read it back are on storage (fdatasync)
+    DATA,
+
+    /// @brief Wait until data and all metadata are on storage (fsync)
+    FULL,
+
+    DEFAULT = FULL,
+  };
+
   /// @brief Construct a File bound to invalid os::Handle
   File() noexcept = default;
 
@@ -152,14 +174,79 @@ public:
     return try_write_some(std::string_view{arr});
   }
 
-  /// @brief Free allocated resources and invalidate underlying handle
+  /// @brief Maximum amount of ranges write_at_parallel splits data into
+  constexpr static size_t MAX_PARALLEL_RANGES = 8;
+
+  /// @brief Read bytes at offset into buffer until it is full. File's own offset is not changed,
+  ///        so reads and writes at different offsets may run concurrently
+  /// @returns Number of bytes read, less than buffer size if EOF was reached, or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  read_at(Reactor &, std::span<char>, uint64_t offset) noexcept;
+
+  /// @brief Read bytes at offset into buffer if file is read-ready. File's own offset is not
+  ///        changed
+  /// @returns 0 bytes read if EOF was reached
+  /// @returns Number of bytes read or a syscall error
+  Result<size_t, SyscallError> try_read_some_at(std::span<char>, uint64_t offset) noexcept;
+
+  /// @brief Read bytes at offset scattering them into buffers in order until all of them are
+  ///        full. File's own offset is not changed
+  /// @returns Number of bytes read, less than total size if EOF was reached, or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  read_vectored_at(Reactor &, std::span<std::span<char> const>, uint64_t offset) noexcept;
+
+  /// @brief Write all bytes from buffer at offset. File's own offset is not changed, so writes
+  ///        at different offsets may run concurrently
+  /// @returns Number of bytes written or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  write_at(Reactor &, std::span<char const>, uint64_t offset) noexcept;
+
+  /// @brief Write bytes from buffer at offset if file is write-ready. File's own offset is not
+  ///        changed
+  /// @returns Number of bytes written or a syscall error
+  Result<size_t, SyscallError> try_write_some_at(std::span<char const>, uint64_t offset) noexcept;
+
+  /// @brief Write all bytes of all buffers in order at offset, gathering them. File's own offset
+  ///        is not changed
+  /// @returns Number of bytes written or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  write_vectored_at(Reactor &, std::span<std::span<char const> const>, uint64_t offset) noexcept;
+
+  /// @brief Split data into up to ranges contiguous ranges and write them at offset concurrently.
+  ///        Useful for large dumps on storage which benefits from deeper queue
+  /// @returns Nothing if all of data was written or the first error among the ranges
+  Fut<void, Error<AllocationError, SyscallError>>
+  write_at_parallel(Reactor &,
+                    std::span<char const>,
+                    uint64_t offset,
+                    size_t ranges = MAX_PARALLEL_RANGES) noexcept;
+
+  /// @brief Make data written into this file durable according to its policy. Writeback is
+  ///        started first and other coroutines are let to run while storage works, so waiting
+  ///        for the rest of it is short
+  Fut<void, Error<AllocationError, SyscallError>> sync(Reactor &) noexcept;
+
+  /// @brief Set durability policy which is applied by sync and close
+  void set_durability(Durability) noexcept;
+
+  /// @brief Get durability policy which is applied by sync and close
+  [[nodiscard]] Durability durability() const noexcept;
+
+  /// @brief Free allocated resources and invalidate underlying handle. If file is open for
+  ///        writing, durability policy is applied first, whatever path data was written through
+  /// @note Durability other than NONE or WRITE_BEHIND makes close block until storage is done
   void close() noexcept;
 
+  /// @brief Tell if close is going to apply durability policy
+  [[nodiscard]] bool syncs_on_close() const noexcept;
+
   /// @brief Get OS-specific underlying handle
   [[nodiscard]] os::Handle underlying_handle() const noexcept;
 
 private:
   SetDefaultOnMove<int, -1> m_fd;
+  Durability m_durability = Durability::DEFAULT;
+  bool m_writable = false;
 };
 
 template <>
@@ -0,0 +1,122 @@
+#ifndef COROSIG_IO_MAPPED_LOG_RING_HPP
+#define COROSIG_IO_MAPPED_LOG_RING_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace corosig {
+
+/// @brief A log ring kept in a file mapped with MAP_SHARED. Threads append to it lock-free during
+///        normal operation and the newest capacity() bytes are kept. Appended bytes are in the
+///        page cache right away, so they survive a crash of the process without a single write
+///        syscall. Signal handler only has to seal the ring and maybe sync it
+/// @code
+/// // at startup
+/// COROSIG_TRY(auto ring, MappedLogRing::open({.path = "app.log", .min_capacity = 1 << 20}));
+/// // from any thread
+/// ring.append("request handled\n");
+/// // in a signal handler
+/// ring.seal();
+/// @endcode
+struct MappedLogRing {
+  struct Options {
+    /// @brief File to keep the ring in. Created if does not exist
+    char const *path;
+
+    /// @brief Capacity is rounded up to a power of two which is not less than a page
+    size_t min_capacity;
+
+    /// @brief Keep contents and positions of a ring which is already in the file, if it has the
+    ///        same capacity. Useful for reading what previous run has left. Otherwise ring is
+    ///        reset
+    bool keep_contents = false;
+  };
+
+  /// @brief Create or open a file and map a ring in it
+  /// @note Blocking. Meant to be called at startup, not from signal handler
+  static Result<MappedLogRing, SyscallError> open(Options const &) noexcept;
+
+  MappedLogRing(MappedLogRing const &) = delete;
+  MappedLogRing(MappedLogRing &&) noexcept;
+  MappedLogRing &operator=(MappedLogRing const &) = delete;
+  MappedLogRing &operator=(MappedLogRing &&) noexcept;
+  ~MappedLogRing();
+
+  /// @brief Append bytes, overwriting the oldest ones if there is no space left
+  /// @note Thread-safe and async-signal-safe. Makes no syscalls
+  void append(std::span<char const>) noexcept;
+
+  /// @brief Append bytes from string literal, excluding null-terminator
+  template <size_t N>
+  void append(char const (&arr)[N]) noexcept // NOLINT(modernize-avoid-c-arrays)
+  {
+    append(std::string_view{arr});
+  }
+
+  /// @brief Write a commit marker with the current end of the ring, so that whoever reads the
+  ///        file later knows the log was complete up to there
+  /// @returns false if some append was in progress, so the newest bytes may be torn
+  /// @note Async-signal-safe. Makes no syscalls
+  bool seal() noexcept;
+
+  /// @brief Get the end position written by the last seal, or 0 if the ring was never sealed
+  [[nodiscard]] uint64_t sealed() const noexcept;
+
+  /// @brief Flush the mapping to storage. Not needed to survive a crash of the process, only
+  ///        a crash of the whole system
+  /// @param wait Wait for the storage to complete the write, otherwise only start it
+  Result<void, SyscallError> sync(bool wait = true) noexcept;
+
+  /// @brief Get kept bytes, oldest first, as up to two spans
+  [[nodiscard]] std::array<std::span<char const>, 2> readable_parts() const noexcept;
+
+  /// @brief Get the total amount of bytes ever appended
+  [[nodiscard]] uint64_t end() const noexcept;
+
+  /// @brief Get the amount of kept bytes
+  [[nodiscard]] size_t size() const noexcept;
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return m_capacity;
+  }
+
+  /// @brief Write all kept bytes into writer, which is File, TcpSocket or alike. Ring contents are
+  ///        not dropped
+  /// @returns Amount of bytes written
+  template <typename WRITER>
+  Fut<size_t, Error<AllocationError, SyscallError>> write_to(Reactor &r, WRITER &writer) noexcept {
+    size_t written = 0;
+    for (std::span<char const> part : readable_parts()) {
+      if (!part.empty()) {
+        COROSIG_CO_TRY(size_t n, co_await writer.write(r, part));
+        written += n;
+      }
+    }
+    co_return written;
+  }
+
+private:
+  struct Header;
+
+  MappedLogRing(Header *header, size_t capacity) noexcept;
+
+  [[nodiscard]] size_t mapping_size() const noexcept;
+
+  void release() noexcept;
+
+  Header *m_header = nullptr;
+  char *m_data = nullptr;
+  size_t m_capacity = 0;
+};
+
+} // namespace corosig
+
+#endif
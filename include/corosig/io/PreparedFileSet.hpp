@@ -0,0 +1,78 @@
+#ifndef COROSIG_IO_PREPARED_FILE_SET_HPP
+#define COROSIG_IO_PREPARED_FILE_SET_HPP
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/File.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace corosig {
+
+/// @brief A set of files which are created and have their space allocated in advance, so a
+///        signal handler only takes one and writes into it. Path lookup, inode creation and block
+///        allocation all happen in prepare during normal operation instead of at crash time
+struct PreparedFileSet {
+  /// @brief Maximum amount of files a set can hold
+  constexpr static size_t MAX_FILES = 8;
+
+  struct Options {
+    /// @brief Paths of files to prepare. Existing files are truncated. Paths above MAX_FILES are
+    ///        ignored
+    std::span<char const *const> paths;
+
+    /// @brief Amount of bytes to allocate in each file. On Linux they are allocated past the end
+    ///        of file, which stays empty until written into. Elsewhere the file is grown to this
+    ///        size, so it ends with zeros until close cuts it down, which never happens if the
+    ///        process dies in the handler
+    size_t reserve_size = size_t{1} << 20;
+
+    /// @brief Permissions for created files
+    File::OpenPerms perms = File::OpenPerms::DEFAULT;
+  };
+
+  /// @brief Make an empty set. Call prepare to fill it
+  PreparedFileSet() noexcept = default;
+
+  PreparedFileSet(PreparedFileSet const &) = delete;
+  PreparedFileSet(PreparedFileSet &&) = delete;
+  PreparedFileSet &operator=(PreparedFileSet const &) = delete;
+  PreparedFileSet &operator=(PreparedFileSet &&) = delete;
+
+  /// @brief Calls close
+  ~PreparedFileSet();
+
+  /// @brief Close currently held files and create, open and allocate ones from options
+  /// @note Blocking. Meant to be called at startup, not from signal handler
+  Result<void, SyscallError> prepare(Options const &) noexcept;
+
+  /// @brief Take next prepared file. It is positioned at zero and stays owned by the set, so it
+  ///        must not be closed by caller
+  /// @returns nullptr if all files were already taken
+  /// @note Async-signal-safe
+  [[nodiscard]] File *acquire() noexcept;
+
+  /// @brief Get amount of files which were not taken yet
+  [[nodiscard]] size_t available() const noexcept;
+
+  /// @brief Get amount of prepared files
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// @brief Cut each file down to the length written into it, releasing unused allocated space,
+  ///        and close it. Written length is taken from file's own offset, so only writes through
+  ///        read/write family count
+  /// @returns The first error met. Files are closed anyway
+  Result<void, SyscallError> close() noexcept;
+
+private:
+  std::array<File, MAX_FILES> m_files;
+  size_t m_size = 0;
+  std::atomic<size_t> m_next = 0;
+};
+
+} // namespace corosig
+
+#endif
@@ -4,6 +4,7 @@
 #include "corosig/util/Variant.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string_view>
@@ -89,6 +90,38 @@ struct IpvNAddr : Variant<Ipv4Addr, Ipv6Addr> {
   constexpr auto operator<=>(IpvNAddr const &) const noexcept = default;
 };
 
+/// @brief Unix domain socket address. Either a filesystem path or a name in Linux abstract
+///        namespace
+/// @note Names may not contain zero bytes, so that address length can be restored from a
+///       SockaddrStorage alone
+struct UnixAddr {
+  /// @brief Maximum length of a path or an abstract name
+  constexpr static size_t MAX_NAME_SIZE = 107;
+
+  /// @brief Make an address of a socket file. Fails on empty or too long paths
+  [[nodiscard]] static std::optional<UnixAddr> from_path(std::string_view path) noexcept;
+
+  /// @brief Make an address in abstract namespace, which does not exist in filesystem and
+  ///        disappears with the last socket bound to it. Fails on empty or too long names
+  [[nodiscard]] static std::optional<UnixAddr> abstract(std::string_view name) noexcept;
+
+  /// @brief Convert this to SockaddrStorage
+  [[nodiscard]] SockaddrStorage to_sockaddr() const noexcept;
+
+  /// @brief Get a path or an abstract name, without leading zero byte
+  [[nodiscard]] std::string_view name() const noexcept;
+
+  /// @brief Tell whether address is in abstract namespace
+  [[nodiscard]] bool is_abstract() const noexcept;
+
+  constexpr auto operator<=>(UnixAddr const &) const noexcept = default;
+
+private:
+  std::array<char, MAX_NAME_SIZE> m_name = {};
+  uint8_t m_size = 0;
+  bool m_abstract = false;
+};
+
 } // namespace corosig
 
 #endif
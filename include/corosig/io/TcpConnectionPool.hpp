@@ -0,0 +1,102 @@
+#ifndef COROSIG_IO_TCP_CONNECTION_POOL_HPP
+#define COROSIG_IO_TCP_CONNECTION_POOL_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/TcpSocket.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace corosig {
+
+/// @brief Keeps connections to a single target established in advance, so a signal handler can
+///        take one instead of spending a handshake at crash time. Pool is maintained with refill
+///        or maintain during normal operation, while checkout is async-signal-safe and may
+///        interrupt them at any point
+struct TcpConnectionPool {
+  /// @brief Maximum amount of connections a pool can hold
+  constexpr static size_t MAX_CONNECTIONS = 16;
+
+  struct Options {
+    /// @brief An address to establish connections with
+    SockaddrStorage const &target;
+
+    /// @brief Amount of connections to keep. Values above MAX_CONNECTIONS are clamped
+    size_t size = 1;
+
+    /// @brief If not zero, enable SO_KEEPALIVE, so kernel probes connections idle for that long
+    ///        and refill notices dead ones even if peer has vanished silently
+    std::chrono::seconds keepalive_idle{0};
+  };
+
+  /// @brief Make a pool without any connections. Call refill to establish them
+  explicit TcpConnectionPool(Options) noexcept;
+
+  TcpConnectionPool(TcpConnectionPool const &) = delete;
+  TcpConnectionPool(TcpConnectionPool &&) = delete;
+  TcpConnectionPool &operator=(TcpConnectionPool const &) = delete;
+  TcpConnectionPool &operator=(TcpConnectionPool &&) = delete;
+
+  ~TcpConnectionPool() = default;
+
+  /// @brief Drop connections which were closed by peer and establish missing ones
+  /// @returns Amount of ready connections. If there are none, an error of the last failed connect
+  ///          is returned instead
+  Fut<size_t, Error<AllocationError, SyscallError>> refill(Reactor &) noexcept;
+
+  /// @brief Call refill right away and then once per interval, so connections which have died or
+  ///        were checked out are replaced. Failed refills are retried on the next round
+  /// @returns Never completes. Drop the future to stop maintenance
+  /// @code
+  /// auto maintenance = pool.maintain(r, 1s);
+  /// COROSIG_CO_TRYV(co_await serve(r, pool));
+  /// @endcode
+  Fut<void> maintain(Reactor &, std::chrono::milliseconds interval) noexcept;
+
+  /// @brief Take an established connection out of the pool. The only syscall made is a
+  ///        non-blocking peek at each candidate to skip ones closed by peer
+  /// @returns Connection or ENOTCONN if there are no live connections in the pool
+  /// @note Async-signal-safe
+  Result<TcpSocket, SyscallError> checkout() noexcept;
+
+  /// @brief Put a connection back into the pool. It is closed if the pool is already full
+  /// @note Async-signal-safe
+  void checkin(TcpSocket) noexcept;
+
+  /// @brief Get amount of connections which are ready for checkout
+  [[nodiscard]] size_t ready() const noexcept;
+
+  /// @brief Get amount of connections the pool tries to keep
+  [[nodiscard]] size_t size() const noexcept;
+
+private:
+  enum class SlotState : uint8_t {
+    EMPTY,
+    /// Owned by refill or checkin, which is filling or probing the slot
+    BUSY,
+    READY,
+  };
+
+  struct Slot {
+    std::atomic<SlotState> state = SlotState::EMPTY;
+    /// Accessed only by the one who has moved state out of READY or EMPTY
+    TcpSocket socket;
+  };
+
+  static_assert(std::atomic<SlotState>::is_always_lock_free);
+
+  SockaddrStorage m_target;
+  size_t m_size;
+  std::chrono::seconds m_keepalive_idle;
+  std::array<Slot, MAX_CONNECTIONS> m_slots;
+};
+
+} // namespace corosig
+
+#endif
@@ -9,7 +9,10 @@
 #include "corosig/reactor/Reactor.hpp"
 #include "corosig/util/SetDefaultOnMove.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <limits>
+#include <span>
 
 namespace corosig {
 
@@ -33,6 +36,16 @@ struct TcpListener {
 
     /// @brief Allow listening on the same port even if addresses are the same
     bool reuse_port = false;
+
+    /// @brief If not zero, connections are surfaced by accept only once client has sent some data
+    ///        or this timeout has expired (TCP_DEFER_ACCEPT). Linux only, fails with ENOSYS
+    ///        elsewhere
+    std::chrono::seconds defer_accept{0};
+
+    /// @brief If not zero, accept TCP Fast Open connections, keeping up to this many of them
+    ///        pending before handshake is complete (TCP_FASTOPEN). Linux only, fails with ENOSYS
+    ///        elsewhere
+    size_t fastopen_queue_size = 0;
   };
 
   /// @brief Construct a ListenerSocket bound to invalid os::Handle
@@ -65,6 +78,16 @@ struct TcpListener {
   /// @brief Accept next incoming connection if it is already in a backlog
   Result<AcceptResult, SyscallError> try_accept() noexcept;
 
+  /// @brief Wait for incoming connections and accept as many of them as there are in a backlog,
+  ///        as long as there are slots for them
+  /// @returns Amount of filled slots or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> accept_batch(Reactor &,
+                                                                 std::span<AcceptResult>) noexcept;
+
+  /// @brief Accept connections which are already in a backlog, as long as there are slots for them
+  /// @returns Amount of filled slots or a syscall error. Fails with EAGAIN if backlog is empty
+  Result<size_t, SyscallError> try_accept_batch(std::span<AcceptResult>) noexcept;
+
   /// @brief Get an address to which socket has been actually bound
   Result<SockaddrStorage, SyscallError> address() const noexcept;
 
@@ -37,6 +37,16 @@ public:
   static Fut<TcpSocket, Error<AllocationError, SyscallError>>
   connect_from(Reactor &, SockaddrStorage const &local, SockaddrStorage const &target) noexcept;
 
+  /// @brief Make a TCP connection to specified target addr and send payload to it. With TCP Fast
+  ///        Open the first chunk of payload is carried by SYN, saving a round trip. If there is no
+  ///        fast open cookie for target yet or fast open is disabled, connection is established
+  ///        as usual before payload is sent
+  /// @returns Socket with whole payload written or syscall error
+  static Fut<TcpSocket, Error<AllocationError, SyscallError>>
+  connect_and_send(Reactor &,
+                   SockaddrStorage const &target,
+                   std::span<char const> payload) noexcept;
+
   /// @brief Construct a TCP socket which owns given os::Handle
   /// @warn This is user's responsibility to provide a handle to an actually valid TcpSocket
   static TcpSocket make_from_os_specific_handle(os::Handle handle) noexcept;
@@ -0,0 +1,34 @@
+#ifndef COROSIG_IO_TRANSFER_HPP
+#define COROSIG_IO_TRANSFER_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace corosig {
+
+/// @brief Send len bytes of file starting at offset into socket. Data is copied by the kernel
+///        without passing through userspace buffers, so this is the cheapest way to ship existing
+///        log or dump file out of the process. File's own offset is not changed
+/// @returns Amount of bytes sent, which is less than len if the file has ended earlier or if an
+///          error happened after some data was already sent
+/// @note Linux only, elsewhere fails with ENOSYS
+Fut<size_t, Error<AllocationError, SyscallError>>
+transfer(Reactor &, File &from, TcpSocket &to, uint64_t offset, size_t len) noexcept;
+
+/// @brief Move up to len bytes from one pipe into another without copying them through userspace
+/// @returns Amount of bytes moved, which is less than len if write end of from was closed or if
+///          an error happened after some data was already moved
+/// @note Linux only, elsewhere fails with ENOSYS
+Fut<size_t, Error<AllocationError, SyscallError>>
+transfer(Reactor &, PipeRead &from, PipeWrite &to, size_t len) noexcept;
+
+} // namespace corosig
+
+#endif
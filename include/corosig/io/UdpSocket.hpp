@@ -13,9 +13,32 @@
 
 namespace corosig {
 
+/// @brief One datagram of UdpSocket::send_batch
+struct OutgoingDatagram {
+  std::span<char const> data;
+  /// @brief Where to send the datagram. Must not be nullptr
+  SockaddrStorage const *dest = nullptr;
+};
+
+/// @brief Slot for one datagram of UdpSocket::recv_batch
+struct IncomingDatagram {
+  /// @brief Buffer to receive datagram into. Datagrams which do not fit are truncated
+  std::span<char> buffer;
+  /// @brief Set to the size of received datagram, which is never truncated
+  size_t size = 0;
+  /// @brief If not nullptr, set to tell where did the datagram come from
+  SockaddrStorage *source = nullptr;
+};
+
 /// @brief An asynchronous UDP socket
 struct UdpSocket {
 public:
+  /// @brief Maximum amount of datagrams passed to kernel in a single syscall by batch operations
+  constexpr static size_t MAX_BATCH_SIZE = 16;
+
+  /// @brief Maximum size of a single datagram payload over IPv4
+  constexpr static size_t MAX_PAYLOAD_SIZE = 65507;
+
   /// @brief Construct a UDP socket which refers to invalid os::Handle
   UdpSocket() noexcept = default;
 
@@ -88,6 +111,47 @@ public:
     return try_send_to(std::string_view{arr}, dest);
   }
 
+  /// @brief Send all datagrams, passing up to MAX_BATCH_SIZE of them to kernel at once
+  /// @returns Amount of sent datagrams, which is less than requested only if an error happened
+  ///          after some of them were already sent
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  send_batch(Reactor &, std::span<OutgoingDatagram const>) noexcept;
+
+  /// @brief Send as many datagrams as possible with a single syscall if socket is write-ready
+  /// @returns Amount of sent datagrams or a syscall error
+  Result<size_t, SyscallError> try_send_batch(std::span<OutgoingDatagram const>) noexcept;
+
+  /// @brief Wait for at least one datagram and then receive all already pending ones, as long as
+  ///        there are slots for them
+  /// @returns Amount of filled slots or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  recv_batch(Reactor &, std::span<IncomingDatagram>) noexcept;
+
+  /// @brief Receive already pending datagrams, as long as there are slots for them
+  /// @returns Amount of filled slots or a syscall error. Fails with EAGAIN if there are no
+  ///          pending datagrams
+  Result<size_t, SyscallError> try_recv_batch(std::span<IncomingDatagram>) noexcept;
+
+  /// @brief Send buffer as consecutive datagrams of segment_size bytes each, the last one may be
+  ///        shorter. Segmentation is offloaded to kernel with UDP_SEGMENT when it is supported,
+  ///        otherwise datagrams are sent in batches
+  /// @returns Amount of sent bytes, which is less than buffer size only if an error happened after
+  ///          some of the datagrams were already sent
+  /// @note Segments which do not fit into path MTU make kernel reject segmentation offload, so
+  ///       socket falls back to batches from then on
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  send_segmented(Reactor &,
+                 std::span<char const> buffer,
+                 size_t segment_size,
+                 SockaddrStorage const &dest) noexcept;
+
+  /// @brief Send as much of segmented buffer as possible with a single syscall if socket is
+  ///        write-ready
+  /// @returns Amount of sent bytes, always a multiple of segment_size unless whole buffer was sent
+  Result<size_t, SyscallError> try_send_segmented(std::span<char const> buffer,
+                                                  size_t segment_size,
+                                                  SockaddrStorage const &dest) noexcept;
+
   /// @brief Get an address to which socket has been bound
   Result<SockaddrStorage, SyscallError> address() const noexcept;
 
@@ -98,7 +162,12 @@ public:
   [[nodiscard]] os::Handle underlying_handle() const noexcept;
 
 private:
+  Result<size_t, SyscallError> try_send_segments_in_batch(std::span<char const> buffer,
+                                                          size_t segment_size,
+                                                          SockaddrStorage const &dest) noexcept;
+
   SetDefaultOnMove<int, -1> m_fd;
+  bool m_segmentation_unsupported = false;
 };
 
 } // namespace corosig
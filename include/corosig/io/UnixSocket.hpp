@@ -0,0 +1,298 @@
+#ifndef COROSIG_IO_UNIX_SOCKET_HPP
+#define COROSIG_IO_UNIX_SOCKET_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/util/SetDefaultOnMove.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace corosig {
+
+/// @brief Maximum amount of handles passed with a single message
+constexpr size_t MAX_PASSED_HANDLES = 16;
+
+/// @brief Result of receiving a message which may carry handles
+struct ReceivedWithHandles {
+  /// @brief Amount of received bytes
+  size_t size = 0;
+  /// @brief Amount of handles written to the output span
+  size_t handles = 0;
+};
+
+/// @brief An asynchronous connected Unix domain stream socket
+struct UnixStream {
+public:
+  /// @brief Construct a Unix stream which refers to invalid os::Handle
+  UnixStream() noexcept = default;
+
+  /// @brief Connect to a listening Unix socket at specified addr
+  /// @returns Ready-for-write socket or syscall error
+  static Fut<UnixStream, Error<AllocationError, SyscallError>>
+  connect(Reactor &, SockaddrStorage const &target) noexcept;
+
+  /// @brief Make a pair of Unix streams connected to each other
+  static Result<std::array<UnixStream, 2>, SyscallError> make_pair() noexcept;
+
+  /// @brief Construct a Unix stream which owns given os::Handle
+  /// @warn This is user's responsibility to provide a handle to an actually valid Unix stream
+  static UnixStream make_from_os_specific_handle(os::Handle handle) noexcept;
+
+  UnixStream(UnixStream const &) = delete;
+  UnixStream(UnixStream &&) noexcept = default;
+  UnixStream &operator=(UnixStream const &) = delete;
+  UnixStream &operator=(UnixStream &&rhs) noexcept {
+    if (this != &rhs) {
+      this->~UnixStream();
+      new (this) UnixStream{std::move(rhs)};
+    }
+    return *this;
+  }
+
+  ~UnixStream();
+
+  /// @brief Read bytes into buffer until it is full
+  /// @returns 0 bytes read if EOF was reached
+  /// @returns Number of bytes read or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> read(Reactor &, std::span<char>) noexcept;
+
+  /// @brief Read bytes into buffer
+  /// @returns 0 bytes read if EOF was reached
+  /// @returns Number of bytes read or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> read_some(Reactor &, std::span<char>) noexcept;
+
+  /// @brief Read bytes into buffer if socket is read-ready
+  /// @returns 0 bytes read if EOF was reached
+  /// @returns Number of bytes read or a syscall error
+  Result<size_t, SyscallError> try_read_some(std::span<char>) noexcept;
+
+  /// @brief Write all bytes from buffer
+  /// @returns Number of bytes written or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> write(Reactor &,
+                                                          std::span<char const>) noexcept;
+
+  /// @brief Write all bytes from string literal, excluding null-terminator
+  /// @returns Number of bytes written or a syscall error
+  template <size_t N>
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  write(Reactor &r,
+        char const (&arr)[N]) noexcept // NOLINT(modernize-avoid-c-arrays)
+  {
+    return write(r, std::string_view{arr});
+  }
+
+  /// @brief Write bytes from buffer
+  /// @returns Number of bytes written or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> write_some(Reactor &,
+                                                               std::span<char const>) noexcept;
+
+  /// @brief Write bytes from buffer if socket is write-ready
+  /// @returns Number of bytes written or a syscall error
+  Result<size_t, SyscallError> try_write_some(std::span<char const>) noexcept;
+
+  /// @brief Send bytes from buffer together with duplicates of given handles (SCM_RIGHTS). Peer
+  ///        receives handles with the first byte of the buffer, so the buffer must not be empty
+  /// @returns Number of bytes written or a syscall error. Handles are passed if at least one byte
+  ///          was written
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  send_handles(Reactor &, std::span<char const>, std::span<os::Handle const>) noexcept;
+
+  /// @brief Send bytes and handles if socket is write-ready
+  /// @returns Number of bytes written or a syscall error
+  Result<size_t, SyscallError> try_send_handles(std::span<char const>,
+                                                std::span<os::Handle const>) noexcept;
+
+  /// @brief Read bytes into buffer, accepting handles sent with them. Received handles are owned
+  ///        by caller and have close-on-exec flag set
+  /// @returns Amount of bytes and handles received or a syscall error
+  /// @note Handles which do not fit into the output span are closed by kernel
+  Fut<ReceivedWithHandles, Error<AllocationError, SyscallError>>
+  recv_handles(Reactor &, std::span<char>, std::span<os::Handle>) noexcept;
+
+  /// @brief Read bytes and handles if socket is read-ready
+  /// @returns Amount of bytes and handles received or a syscall error
+  Result<ReceivedWithHandles, SyscallError> try_recv_handles(std::span<char>,
+                                                             std::span<os::Handle>) noexcept;
+
+  /// @brief Get an address to which socket has been bound
+  Result<SockaddrStorage, SyscallError> address() const noexcept;
+
+  /// @brief Free allocated resources and invalidate underlying handle
+  void close() noexcept;
+
+  /// @brief Get OS-specific underlying handle
+  [[nodiscard]] os::Handle underlying_handle() const noexcept;
+
+private:
+  SetDefaultOnMove<int, -1> m_fd;
+};
+
+/// @brief An asynchronous listener for incoming Unix domain stream connections
+struct UnixListener {
+  struct Options {
+    /// @brief An address to listen at
+    /// @note Socket file of a path address is left in filesystem after the listener is closed and
+    ///       makes further binds fail with EADDRINUSE until it is removed
+    SockaddrStorage const &addr;
+
+    /// @brief Size of a listener's backlog. When there are more pending connections than that,
+    ///        incoming connections may be refused
+    size_t backlog_size = std::numeric_limits<size_t>::max();
+  };
+
+  /// @brief Construct a listener bound to invalid os::Handle
+  UnixListener() noexcept = default;
+
+  /// @brief Make new listener socket with given options. If any of underlying syscalls fails, an
+  ///        error is returned instead
+  static Result<UnixListener, SyscallError> make(Options options) noexcept;
+
+  /// @brief Construct listener which owns given os::Handle
+  /// @warn This is user's responsibility to provide a handle to an actually valid listener socket
+  static UnixListener make_from_os_specific_handle(os::Handle handle) noexcept;
+
+  UnixListener(UnixListener const &) = delete;
+  UnixListener(UnixListener &&) noexcept = default;
+  UnixListener &operator=(UnixListener const &) = delete;
+  UnixListener &operator=(UnixListener &&rhs) noexcept {
+    if (this != &rhs) {
+      this->~UnixListener();
+      new (this) UnixListener{std::move(rhs)};
+    }
+    return *this;
+  }
+
+  ~UnixListener();
+
+  /// @brief Accept next incoming connection or get a syscall error trying
+  Fut<UnixStream, Error<AllocationError, SyscallError>> accept(Reactor &) noexcept;
+
+  /// @brief Accept next incoming connection if it is already in a backlog
+  Result<UnixStream, SyscallError> try_accept() noexcept;
+
+  /// @brief Get an address to which socket has been actually bound
+  Result<SockaddrStorage, SyscallError> address() const noexcept;
+
+  /// @brief Free allocated resources and invalidate underlying handle
+  void close() noexcept;
+
+  /// @brief Get OS-specific underlying handle
+  [[nodiscard]] os::Handle underlying_handle() const noexcept;
+
+private:
+  SetDefaultOnMove<int, -1> m_fd;
+};
+
+/// @brief An asynchronous Unix domain datagram socket
+struct UnixDatagram {
+public:
+  /// @brief Construct a Unix datagram socket which refers to invalid os::Handle
+  UnixDatagram() noexcept = default;
+
+  /// @brief Make a Unix datagram socket which is not bound to any addr. Or get a syscall error
+  static Result<UnixDatagram, SyscallError> unbound() noexcept;
+
+  /// @brief Make a Unix datagram socket which is bound to a specific addr. Or get a syscall error
+  static Result<UnixDatagram, SyscallError> bound(SockaddrStorage const &local) noexcept;
+
+  /// @brief Make a pair of Unix datagram sockets connected to each other
+  static Result<std::array<UnixDatagram, 2>, SyscallError> make_pair() noexcept;
+
+  /// @brief Construct a Unix datagram socket which owns given os::Handle
+  /// @warn This is user's responsibility to provide a handle to an actually valid socket
+  static UnixDatagram make_from_os_specific_handle(os::Handle handle) noexcept;
+
+  UnixDatagram(UnixDatagram const &) = delete;
+  UnixDatagram(UnixDatagram &&) noexcept = default;
+  UnixDatagram &operator=(UnixDatagram const &) = delete;
+  UnixDatagram &operator=(UnixDatagram &&rhs) noexcept {
+    if (this != &rhs) {
+      this->~UnixDatagram();
+      new (this) UnixDatagram{std::move(rhs)};
+    }
+    return *this;
+  }
+
+  ~UnixDatagram();
+
+  /// @brief Receive a datagram into buffer
+  /// @returns Size of received datagram or a syscall error
+  /// @param source If source is not nullptr, it is set to tell where did the datagram come from
+  /// @note If datagram size is greater than given buffer, it is truncated to fit the buffer.
+  ///       Returned size is never truncated
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  recv_from(Reactor &, std::span<char>, SockaddrStorage *source = nullptr) noexcept;
+
+  /// @brief Receive a datagram into buffer if socket is read-ready
+  /// @returns Size of received datagram or a syscall error
+  /// @param source If source is not nullptr, it is set to tell where did the datagram come from
+  /// @note If datagram size is greater than given buffer, it is truncated to fit the buffer.
+  ///       Returned size is never truncated
+  Result<size_t, SyscallError> try_recv_from(std::span<char>,
+                                             SockaddrStorage *source = nullptr) noexcept;
+
+  /// @brief Send a datagram to a specified addr
+  /// @returns Size of sent datagram or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  send_to(Reactor &, std::span<char const>, SockaddrStorage const &dest) noexcept;
+
+  /// @brief Send a datagram to a specified addr if socket is write-ready
+  /// @returns Size of sent datagram or a syscall error
+  Result<size_t, SyscallError> try_send_to(std::span<char const>,
+                                           SockaddrStorage const &dest) noexcept;
+
+  /// @brief Send a datagram to a peer of a connected socket
+  /// @returns Size of sent datagram or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>> send(Reactor &,
+                                                         std::span<char const>) noexcept;
+
+  /// @brief Send a datagram to a peer of a connected socket if socket is write-ready
+  /// @returns Size of sent datagram or a syscall error
+  Result<size_t, SyscallError> try_send(std::span<char const>) noexcept;
+
+  /// @brief Send a datagram together with duplicates of given handles (SCM_RIGHTS) to a peer of
+  ///        a connected socket
+  /// @returns Size of sent datagram or a syscall error
+  Fut<size_t, Error<AllocationError, SyscallError>>
+  send_handles(Reactor &, std::span<char const>, std::span<os::Handle const>) noexcept;
+
+  /// @brief Send a datagram and handles if socket is write-ready
+  /// @returns Size of sent datagram or a syscall error
+  Result<size_t, SyscallError> try_send_handles(std::span<char const>,
+                                                std::span<os::Handle const>) noexcept;
+
+  /// @brief Receive a datagram, accepting handles sent with it. Received handles are owned by
+  ///        caller and have close-on-exec flag set
+  /// @returns Amount of bytes and handles received or a syscall error
+  /// @note Handles which do not fit into the output span are closed by kernel
+  Fut<ReceivedWithHandles, Error<AllocationError, SyscallError>>
+  recv_handles(Reactor &, std::span<char>, std::span<os::Handle>) noexcept;
+
+  /// @brief Receive a datagram and handles if socket is read-ready
+  /// @returns Amount of bytes and handles received or a syscall error
+  Result<ReceivedWithHandles, SyscallError> try_recv_handles(std::span<char>,
+                                                             std::span<os::Handle>) noexcept;
+
+  /// @brief Get an address to which socket has been bound
+  Result<SockaddrStorage, SyscallError> address() const noexcept;
+
+  /// @brief Free allocated resources and invalidate underlying handle
+  void close() noexcept;
+
+  /// @brief Get OS-specific underlying handle
+  [[nodiscard]] os::Handle underlying_handle() const noexcept;
+
+private:
+  SetDefaultOnMove<int, -1> m_fd;
+};
+
+} // namespace corosig
+
+#endif
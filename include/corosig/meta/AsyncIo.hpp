@@ -0,0 +1,35 @@
+#ifndef COROSIG_META_ASYNC_IO_HPP
+#define COROSIG_META_ASYNC_IO_HPP
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+namespace corosig {
+
+/// @brief Concept of a stream which can be read asynchronously, such as File, PipeRead, TcpSocket
+///        or StdIn
+template <typename READER>
+concept AsyncRead = requires(READER &reader, Reactor &r, std::span<char> buf) {
+  { reader.read(r, buf) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+  { reader.read_some(r, buf) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+  { reader.try_read_some(buf) } -> std::same_as<Result<size_t, SyscallError>>;
+};
+
+/// @brief Concept of a stream which can be written asynchronously, such as File, PipeWrite,
+///        TcpSocket or StdOut
+template <typename WRITER>
+concept AsyncWrite = requires(WRITER &writer, Reactor &r, std::span<char const> buf) {
+  { writer.write(r, buf) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+  { writer.write_some(r, buf) } -> std::same_as<Fut<size_t, Error<AllocationError, SyscallError>>>;
+  { writer.try_write_some(buf) } -> std::same_as<Result<size_t, SyscallError>>;
+};
+
+} // namespace corosig
+
+#endif
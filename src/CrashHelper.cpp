@@ -0,0 +1,216 @@
+#include "corosig/CrashHelper.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <span>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace corosig {
+
+struct CrashHelper::Shared {
+  /// Bytes past the staging region are counted, but not stored
+  std::atomic<size_t> reserved = 0;
+  std::atomic<bool> handed_off = false;
+  size_t capacity = 0;
+
+  static_assert(std::atomic<size_t>::is_always_lock_free,
+                "atomics must be lock-free to be shared between processes");
+
+  constexpr static size_t HEADER_SIZE = 64;
+
+  char *data() noexcept {
+    return reinterpret_cast<char *>(this) + HEADER_SIZE;
+  }
+
+  std::span<char const> staged() noexcept {
+    return {data(), std::min(reserved.load(std::memory_order_acquire), capacity)};
+  }
+};
+
+namespace {
+
+/// Helper must not run handlers of the process it was forked from, those are meant for a process
+/// which is not crashed yet
+void reset_signal_handlers() noexcept {
+  for (int sig = 1; sig < NSIG; ++sig) {
+    struct sigaction old {};
+    if (::sigaction(sig, nullptr, &old) == -1) {
+      continue;
+    }
+    bool is_function = (old.sa_flags & SA_SIGINFO) != 0 ||
+                       (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN);
+    if (is_function) {
+      struct sigaction dfl {};
+      dfl.sa_handler = SIG_DFL;
+      (void)::sigaction(sig, &dfl, nullptr);
+    }
+  }
+  sigset_t none;
+  ::sigemptyset(&none);
+  (void)::sigprocmask(SIG_SETMASK, &none, nullptr);
+}
+
+} // namespace
+
+CrashHelper::~CrashHelper() {
+  (void)stop();
+}
+
+Result<void, SyscallError> CrashHelper::start(Options const &options) noexcept {
+  if (m_pid != -1) {
+    return Failure{SyscallError{EBUSY}};
+  }
+
+  size_t mapping_size = Shared::HEADER_SIZE + options.staging_size;
+  void *mapping =
+      ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    return Failure{SyscallError::current()};
+  }
+  auto *shared = new (mapping) Shared{};
+  shared->capacity = options.staging_size;
+
+  std::array<int, 2> fds{};
+  if (::pipe(fds.data()) == -1) {
+    SyscallError error = SyscallError::current();
+    ::munmap(mapping, mapping_size);
+    return Failure{error};
+  }
+  auto [read_fd, write_fd] = fds;
+  (void)::fcntl(write_fd, F_SETFD, FD_CLOEXEC);
+
+  pid_t pid = ::fork();
+  if (pid == -1) {
+    SyscallError error = SyscallError::current();
+    ::close(read_fd);
+    ::close(write_fd);
+    ::munmap(mapping, mapping_size);
+    return Failure{error};
+  }
+  if (pid == 0) {
+    ::close(write_fd);
+    helper_main(*shared, read_fd, options);
+  }
+
+  ::close(read_fd);
+  m_shared = shared;
+  m_mapping_size = mapping_size;
+  m_wake_fd = write_fd;
+  m_pid = pid;
+  return Ok{};
+}
+
+Result<int, SyscallError> CrashHelper::stop() noexcept {
+  if (m_pid == -1) {
+    return Failure{SyscallError{ECHILD}};
+  }
+
+  // Helper sees EOF and exits on its own, unless it is already busy with handed off bytes
+  ::close(m_wake_fd);
+  m_wake_fd = -1;
+
+  int status = 0;
+  pid_t res = -1;
+  do {
+    res = ::waitpid(m_pid, &status, 0);
+  } while (res == -1 && errno == EINTR);
+  SyscallError error = SyscallError::current();
+
+  m_shared->~Shared();
+  ::munmap(m_shared, m_mapping_size);
+  m_shared = nullptr;
+  m_mapping_size = 0;
+  m_pid = -1;
+
+  if (res == -1) {
+    return Failure{error};
+  }
+  return status;
+}
+
+size_t CrashHelper::stage(std::span<char const> bytes) noexcept {
+  if (m_shared == nullptr) {
+    return 0;
+  }
+  size_t offset = m_shared->reserved.fetch_add(bytes.size(), std::memory_order_acq_rel);
+  if (offset >= m_shared->capacity) {
+    return 0;
+  }
+  size_t fit = std::min(bytes.size(), m_shared->capacity - offset);
+  std::memcpy(m_shared->data() + offset, bytes.data(), fit);
+  return fit;
+}
+
+Result<void, SyscallError> CrashHelper::hand_off() noexcept {
+  if (m_pid == -1) {
+    return Failure{SyscallError{ECHILD}};
+  }
+  if (m_shared->handed_off.exchange(true, std::memory_order_acq_rel)) {
+    return Ok{};
+  }
+  char byte = 1;
+  ssize_t res = -1;
+  do {
+    res = ::write(m_wake_fd, &byte, 1);
+  } while (res == -1 && errno == EINTR);
+  if (res == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return Ok{};
+}
+
+pid_t CrashHelper::pid() const noexcept {
+  return m_pid;
+}
+
+size_t CrashHelper::staged() const noexcept {
+  if (m_shared == nullptr) {
+    return 0;
+  }
+  return m_shared->staged().size();
+}
+
+void CrashHelper::helper_main(Shared &shared, os::Handle wake_fd, Options const &options) noexcept {
+  reset_signal_handlers();
+
+  // Helper has nothing else to do, so a plain blocking read is fine here
+  char byte = 0;
+  ssize_t res = -1;
+  do {
+    res = ::read(wake_fd, &byte, 1);
+  } while (res == -1 && errno == EINTR);
+
+  if (!shared.handed_off.load(std::memory_order_acquire) || options.handler == nullptr) {
+    ::_exit(0);
+  }
+
+  void *mem = ::mmap(nullptr, options.reactor_memory, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    ::_exit(1);
+  }
+
+  bool ok = false;
+  {
+    Reactor reactor{std::span{static_cast<char *>(mem), options.reactor_memory}};
+    ok = options.handler(reactor, shared.staged()).block_on().is_ok();
+    (void)reactor.drain_remaining_tasks();
+  }
+  ::_exit(ok ? 0 : 1);
+}
+
+} // namespace corosig
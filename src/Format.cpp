@@ -0,0 +1,376 @@
+#include "corosig/Format.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/util/Endianness.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <span>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+
+using namespace corosig;
+
+constexpr std::string_view LOWER_HEX_DIGITS = "0123456789abcdef";
+constexpr std::string_view UPPER_HEX_DIGITS = "0123456789ABCDEF";
+
+// enough for 64 binary digits
+constexpr size_t MAX_DIGITS = 64;
+
+/// Convert n < 10^8 into 8 decimal digits at once, each in it's own byte of the result, most
+/// significant digit in the lowest byte. Splits number in two 10^4 halves, then each half into
+/// two 10^2 parts and then each part into two digits, processing all lanes with the same
+/// multiplications. Divisions are replaced with multiplications by fixed-point reciprocals, which
+/// are exact in the ranges involved
+constexpr uint64_t eight_digits_swar(uint32_t n) noexcept {
+  uint64_t merged = (n / 10000) | (static_cast<uint64_t>(n % 10000) << 32);
+  // 10486 / 2^20 ~ 1 / 100
+  uint64_t hundreds_hi = ((merged * 10486) >> 20) & 0x0000'007F'0000'007FULL;
+  uint64_t hundreds_lo = merged - (100 * hundreds_hi);
+  uint64_t hundreds = (hundreds_lo << 16) | hundreds_hi;
+  // 103 / 2^10 ~ 1 / 10
+  uint64_t tens_hi = ((hundreds * 103) >> 10) & 0x000F'000F'000F'000FULL;
+  uint64_t tens_lo = hundreds - (10 * tens_hi);
+  return (tens_lo << 8) | tens_hi;
+}
+
+static_assert(eight_digits_swar(12345678) == 0x0807'0605'0403'0201ULL);
+static_assert(eight_digits_swar(90) == 0x0009'0000'0000'0000ULL);
+
+void store_eight_digits(char *out, uint64_t digits) noexcept {
+  uint64_t ascii = digits | 0x3030'3030'3030'3030ULL;
+  if constexpr (std::endian::native == std::endian::big) {
+    ascii = detail::byteswap(ascii);
+  }
+  std::memcpy(out, &ascii, sizeof(ascii));
+}
+
+/// Write decimal digits of value into the end of out
+/// @returns Amount of written digits
+size_t to_decimal(uint64_t value, std::span<char, MAX_DIGITS> out) noexcept {
+  constexpr uint64_t TEN_TO_EIGHT = 100'000'000;
+
+  if (value < 10) {
+    out.back() = static_cast<char>('0' + value);
+    return 1;
+  }
+
+  size_t begin = out.size();
+  uint64_t digits = 0;
+  do {
+    digits = eight_digits_swar(static_cast<uint32_t>(value % TEN_TO_EIGHT));
+    value /= TEN_TO_EIGHT;
+    begin -= 8;
+    store_eight_digits(out.data() + begin, digits);
+  } while (value != 0);
+
+  // most significant chunk is non-zero here, so it has at least one non-zero digit
+  size_t leading_zeros = static_cast<size_t>(std::countr_zero(digits)) / 8;
+  return out.size() - begin - leading_zeros;
+}
+
+/// Write digits of value in base 2^bits_per_digit into the end of out
+/// @returns Amount of written digits
+size_t to_power_of_two_base(uint64_t value,
+                            unsigned bits_per_digit,
+                            std::string_view digit_chars,
+                            std::span<char, MAX_DIGITS> out) noexcept {
+  uint64_t mask = (uint64_t{1} << bits_per_digit) - 1;
+  size_t begin = out.size();
+  do {
+    out[--begin] = digit_chars[value & mask];
+    value >>= bits_per_digit;
+  } while (value != 0);
+  return out.size() - begin;
+}
+
+void format_ipv4(detail::FormatOutput &out, std::array<uint8_t, 4> const &bytes) noexcept {
+  std::array<char, MAX_DIGITS> digits;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    if (i != 0) {
+      out.put('.');
+    }
+    size_t length = to_decimal(bytes[i], digits);
+    out.put(std::string_view{digits.end() - length, digits.end()});
+  }
+}
+
+void format_ipv6(detail::FormatOutput &out, std::array<uint8_t, 16> const &bytes) noexcept {
+  std::array<uint16_t, 8> groups;
+  for (size_t i = 0; i < groups.size(); ++i) {
+    groups[i] = static_cast<uint16_t>((bytes[i * 2] << 8) | bytes[(i * 2) + 1]);
+  }
+
+  // ::ffff:a.b.c.d
+  constexpr std::array<uint16_t, 6> MAPPED_IPV4_PREFIX = {0, 0, 0, 0, 0, 0xffff};
+  if (std::ranges::equal(std::span{groups}.first<6>(), MAPPED_IPV4_PREFIX)) {
+    out.put("::ffff:");
+    format_ipv4(out, {bytes[12], bytes[13], bytes[14], bytes[15]});
+    return;
+  }
+
+  // RFC 5952: compress the longest (leftmost of equal) run of at least two zero groups
+  size_t best_begin = groups.size();
+  size_t best_length = 1;
+  for (size_t i = 0; i < groups.size();) {
+    if (groups[i] != 0) {
+      ++i;
+      continue;
+    }
+    size_t j = i;
+    while (j < groups.size() && groups[j] == 0) {
+      ++j;
+    }
+    if (j - i > best_length) {
+      best_begin = i;
+      best_length = j - i;
+    }
+    i = j;
+  }
+
+  std::array<char, MAX_DIGITS> digits;
+  for (size_t i = 0; i < groups.size(); ++i) {
+    if (i == best_begin) {
+      out.put("::");
+      i += best_length - 1;
+      continue;
+    }
+    if (i != 0 && i != best_begin + best_length) {
+      out.put(':');
+    }
+    size_t length = to_power_of_two_base(groups[i], 4, LOWER_HEX_DIGITS, digits);
+    out.put(std::string_view{digits.end() - length, digits.end()});
+  }
+}
+
+void format_port(detail::FormatOutput &out, uint16_t port) noexcept {
+  std::array<char, MAX_DIGITS> digits;
+  size_t length = to_decimal(port, digits);
+  out.put(':');
+  out.put(std::string_view{digits.end() - length, digits.end()});
+}
+
+} // namespace
+
+namespace corosig {
+
+namespace detail {
+
+void FormatOutput::put(std::string_view text) noexcept {
+  m_total += text.size();
+  while (!text.empty()) {
+    if (m_used == m_buffer.size()) {
+      if (m_drain == nullptr || m_buffer.empty()) {
+        return;
+      }
+      m_drain(m_context, std::string_view{m_buffer.data(), m_used});
+      m_used = 0;
+    }
+    size_t amount = std::min(text.size(), m_buffer.size() - m_used);
+    std::memcpy(m_buffer.data() + m_used, text.data(), amount);
+    m_used += amount;
+    text.remove_prefix(amount);
+  }
+}
+
+void FormatOutput::put(char c) noexcept {
+  put(std::string_view{&c, 1});
+}
+
+void FormatOutput::fill(char c, size_t count) noexcept {
+  std::array<char, 16> chunk;
+  chunk.fill(c);
+  while (count != 0) {
+    size_t amount = std::min(count, chunk.size());
+    put(std::string_view{chunk.data(), amount});
+    count -= amount;
+  }
+}
+
+void FormatOutput::put_literal(std::string_view text, bool has_escapes) noexcept {
+  if (!has_escapes) {
+    put(text);
+    return;
+  }
+  while (!text.empty()) {
+    size_t brace = text.find_first_of("{}");
+    if (brace == std::string_view::npos) {
+      put(text);
+      return;
+    }
+    // escaped braces are doubled, keep the first one
+    put(text.substr(0, brace + 1));
+    text.remove_prefix(std::min(brace + 2, text.size()));
+  }
+}
+
+void FormatOutput::finish() noexcept {
+  if (m_drain != nullptr && m_used != 0) {
+    m_drain(m_context, std::string_view{m_buffer.data(), m_used});
+    m_used = 0;
+  }
+}
+
+void format_integer(FormatOutput &out,
+                    FormatSpec const &spec,
+                    uint64_t magnitude,
+                    bool negative) noexcept {
+  std::array<char, MAX_DIGITS> digits;
+  size_t length = 0;
+  std::string_view prefix;
+  switch (spec.type) {
+  case 'x':
+    length = to_power_of_two_base(magnitude, 4, LOWER_HEX_DIGITS, digits);
+    prefix = "0x";
+    break;
+  case 'X':
+    length = to_power_of_two_base(magnitude, 4, UPPER_HEX_DIGITS, digits);
+    prefix = "0X";
+    break;
+  case 'b':
+    length = to_power_of_two_base(magnitude, 1, LOWER_HEX_DIGITS, digits);
+    prefix = "0b";
+    break;
+  case 'o':
+    length = to_power_of_two_base(magnitude, 3, LOWER_HEX_DIGITS, digits);
+    prefix = magnitude == 0 ? "" : "0";
+    break;
+  default:
+    length = to_decimal(magnitude, digits);
+    break;
+  }
+  if (!spec.alternate) {
+    prefix = {};
+  }
+
+  size_t full_length = length + prefix.size() + (negative ? 1 : 0);
+  size_t padding = spec.width > full_length ? spec.width - full_length : 0;
+  bool pad_right = spec.align == '<';
+
+  if (!pad_right && !spec.zero_pad) {
+    out.fill(' ', padding);
+  }
+  if (negative) {
+    out.put('-');
+  }
+  out.put(prefix);
+  if (!pad_right && spec.zero_pad) {
+    out.fill('0', padding);
+  }
+  out.put(std::string_view{digits.end() - length, digits.end()});
+  if (pad_right) {
+    out.fill(' ', padding);
+  }
+}
+
+void format_pointer(FormatOutput &out, FormatSpec const &spec, uintptr_t address) noexcept {
+  FormatSpec hex = spec;
+  hex.type = 'x';
+  hex.alternate = true;
+  format_integer(out, hex, address, false);
+}
+
+void format_string(FormatOutput &out, FormatSpec const &spec, std::string_view text) noexcept {
+  format_padded(out, spec, true, [&](FormatOutput &o) { o.put(text); });
+}
+
+} // namespace detail
+
+void format_value(detail::FormatOutput &out, FormatSpec const &spec, HexDump const &dump) noexcept {
+  std::string_view digit_chars = spec.type == 'X' ? UPPER_HEX_DIGITS : LOWER_HEX_DIGITS;
+  std::array<char, 3> pair = {' ', ' ', ' '};
+  for (size_t i = 0; i < dump.bytes.size(); ++i) {
+    auto byte = static_cast<uint8_t>(dump.bytes[i]);
+    pair[1] = digit_chars[byte >> 4];
+    pair[2] = digit_chars[byte & 0xf];
+    // separator goes before every pair but the first one
+    out.put(i == 0 ? std::string_view{pair.data() + 1, 2} : std::string_view{pair.data(), 3});
+  }
+}
+
+void format_value(detail::FormatOutput &out,
+                  FormatSpec const &,
+                  SyscallError const &error) noexcept {
+  std::array<char, MAX_DIGITS> digits;
+  int64_t signed_value = error.value;
+  auto value = static_cast<uint64_t>(signed_value < 0 ? -signed_value : signed_value);
+  size_t length = to_decimal(value, digits);
+
+  std::string_view description = error.description();
+  out.put(description.empty() ? std::string_view{"Unknown error"} : description);
+  out.put(" (errno ");
+  if (error.value < 0) {
+    out.put('-');
+  }
+  out.put(std::string_view{digits.end() - length, digits.end()});
+  out.put(')');
+}
+
+void format_value(detail::FormatOutput &out, FormatSpec const &, Ipv4Addr const &addr) noexcept {
+  format_ipv4(out, std::bit_cast<std::array<uint8_t, 4>>(addr.value()));
+}
+
+void format_value(detail::FormatOutput &out, FormatSpec const &, Ipv6Addr const &addr) noexcept {
+  format_ipv6(out, addr.value());
+}
+
+void format_value(detail::FormatOutput &out,
+                  FormatSpec const &spec,
+                  IpvNAddr const &addr) noexcept {
+  addr.match([&](auto const &a) { format_value(out, spec, a); });
+}
+
+void format_value(detail::FormatOutput &out,
+                  FormatSpec const &,
+                  SockaddrStorage const &addr) noexcept {
+  sockaddr_storage const &storage = addr.native_storage;
+  switch (storage.ss_family) {
+  case AF_INET: {
+    sockaddr_in in;
+    std::memcpy(&in, &storage, sizeof(in));
+    format_ipv4(out, std::bit_cast<std::array<uint8_t, 4>>(in.sin_addr.s_addr));
+    format_port(out, betoh(in.sin_port));
+    break;
+  }
+  case AF_INET6: {
+    sockaddr_in6 in6;
+    std::memcpy(&in6, &storage, sizeof(in6));
+    out.put('[');
+    format_ipv6(out, std::bit_cast<std::array<uint8_t, 16>>(in6.sin6_addr));
+    out.put(']');
+    format_port(out, betoh(in6.sin6_port));
+    break;
+  }
+  case AF_UNIX: {
+    sockaddr_un un;
+    std::memcpy(&un, &storage, sizeof(un));
+    std::string_view path{un.sun_path, sizeof(un.sun_path)};
+    if (!path.empty() && path.front() == '\0') {
+      // abstract socket names are conventionally shown with @ in place of leading zero byte
+      out.put('@');
+      path.remove_prefix(1);
+    }
+    out.put(path.substr(0, path.find('\0')));
+    break;
+  }
+  default: {
+    std::array<char, MAX_DIGITS> digits;
+    size_t length = to_decimal(storage.ss_family, digits);
+    out.put("<address family ");
+    out.put(std::string_view{digits.end() - length, digits.end()});
+    out.put('>');
+    break;
+  }
+  }
+}
+
+} // namespace corosig
@@ -0,0 +1,196 @@
+#include "corosig/MemoryProfiler.hpp"
+
+#include "corosig/container/Allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <dlfcn.h>
+#include <span>
+#include <string_view>
+
+namespace {
+
+using namespace corosig;
+
+struct ReportWriter {
+  void put(std::string_view str) noexcept {
+    size_t n = std::min(str.size(), m_buf.size() - m_pos);
+    std::copy_n(str.begin(), n, m_buf.begin() + static_cast<ptrdiff_t>(m_pos));
+    m_pos += n;
+  }
+
+  void put_num(size_t value, int base = 10, size_t width = 0) noexcept {
+    std::array<char, 24> digits;
+    auto [end, ec] = std::to_chars(digits.begin(), digits.end(), value, base);
+    auto len = static_cast<size_t>(end - digits.begin());
+    for (; width > len; --width) {
+      put(" ");
+    }
+    put(std::string_view{digits.begin(), end});
+  }
+
+  [[nodiscard]] std::string_view result() const noexcept {
+    return std::string_view{m_buf.data(), m_pos};
+  }
+
+  std::span<char> m_buf;
+  size_t m_pos = 0;
+};
+
+size_t size_bucket(size_t size) noexcept {
+  return std::min<size_t>(std::bit_width(size), MemoryProfiler::SIZE_BUCKETS - 1);
+}
+
+} // namespace
+
+namespace corosig {
+
+MemoryProfiler::MemoryProfiler(Allocator &alloc) noexcept
+    : m_alloc{alloc} {
+  m_alloc.set_observer(this);
+}
+
+MemoryProfiler::~MemoryProfiler() {
+  m_alloc.set_observer(nullptr);
+}
+
+void MemoryProfiler::on_allocate(void *ptr, size_t size, void const *call_site) noexcept {
+  if (ptr == nullptr) {
+    ++m_failed_allocations;
+    return;
+  }
+
+  ++m_allocations;
+  ++m_live_allocations;
+  m_peak_live_allocations = std::max(m_peak_live_allocations, m_live_allocations);
+  ++m_size_histogram[size_bucket(size)];
+
+  auto tracked = std::span{m_call_sites}.first(m_call_sites_amount);
+  auto it = std::ranges::find(tracked, call_site, &CallSite::address);
+  CallSite *site = nullptr;
+  if (it != tracked.end()) {
+    site = &*it;
+  } else if (m_call_sites_amount < m_call_sites.size()) {
+    site = &m_call_sites[m_call_sites_amount++];
+    site->address = call_site;
+  } else {
+    return;
+  }
+  ++site->allocations;
+  site->total_bytes += size;
+  site->max_bytes = std::max(site->max_bytes, size);
+}
+
+void MemoryProfiler::on_deallocate(void *) noexcept {
+  if (m_live_allocations != 0) {
+    --m_live_allocations;
+  }
+}
+
+size_t MemoryProfiler::peak_memory() const noexcept {
+  return m_alloc.peak_memory();
+}
+
+size_t MemoryProfiler::allocations() const noexcept {
+  return m_allocations;
+}
+
+size_t MemoryProfiler::failed_allocations() const noexcept {
+  return m_failed_allocations;
+}
+
+size_t MemoryProfiler::peak_live_allocations() const noexcept {
+  return m_peak_live_allocations;
+}
+
+std::span<size_t const, MemoryProfiler::SIZE_BUCKETS>
+MemoryProfiler::size_histogram() const noexcept {
+  return m_size_histogram;
+}
+
+std::span<MemoryProfiler::CallSite const> MemoryProfiler::call_sites() noexcept {
+  auto tracked = std::span{m_call_sites}.first(m_call_sites_amount);
+  std::ranges::sort(tracked, std::ranges::greater{}, &CallSite::total_bytes);
+  return tracked;
+}
+
+size_t MemoryProfiler::recommended_budget(size_t headroom_percent) const noexcept {
+  constexpr size_t KIB = 1024;
+  size_t with_headroom = peak_memory() + peak_memory() * headroom_percent / 100;
+  return std::max<size_t>(1, (with_headroom + KIB - 1) / KIB) * KIB;
+}
+
+std::string_view MemoryProfiler::format_report(std::span<char> buffer,
+                                               size_t configured_budget) noexcept {
+  constexpr size_t HEADROOM_PERCENT = 25;
+  constexpr size_t WIDTH = 10;
+
+  ReportWriter out{buffer};
+  out.put("corosig memory profile\n  peak memory:        ");
+  out.put_num(peak_memory(), 10, WIDTH);
+  out.put(" bytes\n");
+  if (configured_budget != 0) {
+    out.put("  configured budget:  ");
+    out.put_num(configured_budget, 10, WIDTH);
+    out.put(" bytes");
+    out.put(configured_budget < peak_memory() ? " (TOO SMALL)\n" : "\n");
+  }
+  out.put("  recommended budget: ");
+  out.put_num(recommended_budget(HEADROOM_PERCENT), 10, WIDTH);
+  out.put(" bytes (+");
+  out.put_num(HEADROOM_PERCENT);
+  out.put("% headroom)\n  allocations:        ");
+  out.put_num(allocations(), 10, WIDTH);
+  out.put(" (");
+  out.put_num(failed_allocations());
+  out.put(" failed, ");
+  out.put_num(peak_live_allocations());
+  out.put(" alive at peak)\n  allocation sizes:\n");
+
+  for (size_t i = 0; i < m_size_histogram.size(); ++i) {
+    if (m_size_histogram[i] == 0) {
+      continue;
+    }
+    out.put("    [");
+    out.put_num(i == 0 ? 0 : size_t{1} << (i - 1), 10, WIDTH);
+    if (i + 1 == m_size_histogram.size()) {
+      out.put(", ...       ): ");
+    } else {
+      out.put(", ");
+      out.put_num(size_t{1} << i, 10, WIDTH);
+      out.put("): ");
+    }
+    out.put_num(m_size_histogram[i]);
+    out.put("\n");
+  }
+
+  out.put("  call sites (module+offset, resolve with addr2line):\n");
+  for (CallSite const &site : call_sites()) {
+    out.put("    ");
+    ::Dl_info info{};
+    if (::dladdr(site.address, &info) != 0 && info.dli_fname != nullptr) {
+      out.put(info.dli_fname);
+      out.put("+0x");
+      out.put_num(reinterpret_cast<uintptr_t>(site.address) -
+                      reinterpret_cast<uintptr_t>(info.dli_fbase),
+                  16);
+    } else {
+      out.put("0x");
+      out.put_num(reinterpret_cast<uintptr_t>(site.address), 16);
+    }
+    out.put("\n      allocations: ");
+    out.put_num(site.allocations);
+    out.put(", bytes: ");
+    out.put_num(site.total_bytes);
+    out.put(", largest: ");
+    out.put_num(site.max_bytes);
+    out.put("\n");
+  }
+
+  return out.result();
+}
+
+} // namespace corosig
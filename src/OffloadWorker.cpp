@@ -0,0 +1,289 @@
+#include "corosig/OffloadWorker.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/PollEvent.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/Yield.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+using namespace corosig;
+
+/// Paths are copied into arguments, so a call never refers to memory of the submitting frame
+using PathBuffer = std::array<char, 256>;
+
+struct OpenArgs {
+  int flags;
+  int perms;
+  PathBuffer path;
+};
+
+struct StatArgs {
+  struct stat out;
+  PathBuffer path;
+};
+
+static_assert(sizeof(OpenArgs) <= OffloadWorker::MAX_ARGS_SIZE);
+static_assert(sizeof(StatArgs) <= OffloadWorker::MAX_ARGS_SIZE);
+
+bool copy_path(PathBuffer &buffer, char const *path) noexcept {
+  size_t size = std::strlen(path);
+  if (size >= buffer.size()) {
+    return false;
+  }
+  std::memcpy(buffer.data(), path, size + 1);
+  return true;
+}
+
+} // namespace
+
+namespace corosig {
+
+OffloadWorker::~OffloadWorker() {
+  stop();
+}
+
+Result<void, SyscallError> OffloadWorker::start() noexcept {
+  if (m_running) {
+    return Ok{};
+  }
+#ifdef __linux__
+  for (Slot &slot : m_slots) {
+    slot.done_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (slot.done_fd == -1) {
+      SyscallError error = SyscallError::current();
+      stop();
+      return Failure{error};
+    }
+  }
+
+  // Worker must never run a signal handler, otherwise it could end up waiting on itself
+  sigset_t all;
+  sigset_t old;
+  ::sigfillset(&all);
+  ::pthread_sigmask(SIG_SETMASK, &all, &old);
+  int res = ::pthread_create(&m_thread, nullptr, &OffloadWorker::worker_main, this);
+  ::pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+  if (res != 0) {
+    stop();
+    return Failure{SyscallError{res}};
+  }
+  m_running = true;
+  return Ok{};
+#else
+  return Failure{SyscallError{ENOSYS}};
+#endif
+}
+
+void OffloadWorker::stop() noexcept {
+  if (m_running) {
+    m_stop.store(true);
+    wake();
+    ::pthread_join(m_thread, nullptr);
+    m_running = false;
+    m_stop.store(false);
+  }
+  for (Slot &slot : m_slots) {
+    if (slot.done_fd != -1) {
+      ::close(slot.done_fd);
+      slot.done_fd = -1;
+    }
+  }
+}
+
+bool OffloadWorker::running() const noexcept {
+  return m_running;
+}
+
+Fut<long, Error<AllocationError, SyscallError>>
+OffloadWorker::run(Reactor &, Call call, std::span<std::byte> args) noexcept {
+  assert(args.size() <= MAX_ARGS_SIZE && "Arguments do not fit into a slot");
+  if (!m_running) {
+    long result = call(args.data());
+    if (result == -1) {
+      co_return Failure{SyscallError::current()};
+    }
+    co_return result;
+  }
+
+  Slot *slot = nullptr;
+  while (slot == nullptr) {
+    for (Slot &candidate : m_slots) {
+      SlotState expected = SlotState::FREE;
+      if (candidate.state.compare_exchange_strong(expected, SlotState::CLAIMED)) {
+        slot = &candidate;
+        break;
+      }
+    }
+    if (slot == nullptr) {
+      co_await Yield{};
+    }
+  }
+
+  slot->call = call;
+  std::ranges::copy(args, slot->args.begin());
+  slot->state.store(SlotState::SUBMITTED, std::memory_order_release);
+  wake();
+
+  // If this frame is destroyed before the call completes, worker frees the slot instead
+  struct AbandonGuard {
+    Slot *slot;
+
+    ~AbandonGuard() {
+      if (slot == nullptr) {
+        return;
+      }
+      SlotState expected = SlotState::SUBMITTED;
+      if (!slot->state.compare_exchange_strong(expected, SlotState::ABANDONED,
+                                               std::memory_order_acq_rel)) {
+        slot->state.store(SlotState::FREE, std::memory_order_release);
+      }
+    }
+  } guard{slot};
+
+  // Eventfd may be signalled a bit later than DONE is seen or be left signalled by previous call
+  // in the slot, so state is the only source of truth and eventfd just tells when to look again
+  while (slot->state.load(std::memory_order_acquire) != SlotState::DONE) {
+    co_await PollEvent{slot->done_fd, PollEventExpectance::CAN_READ};
+    uint64_t count = 0;
+    (void)::read(slot->done_fd, &count, sizeof(count));
+  }
+
+  long result = slot->result;
+  int error = slot->error;
+  std::ranges::copy(std::span{slot->args}.first(args.size()), args.begin());
+  guard.slot = nullptr;
+  slot->state.store(SlotState::FREE, std::memory_order_release);
+
+  if (result == -1) {
+    co_return Failure{SyscallError{error}};
+  }
+  co_return result;
+}
+
+Fut<File, Error<AllocationError, SyscallError>>
+OffloadWorker::open(Reactor &r,
+                    char const *path,
+                    File::OpenFlags flags,
+                    File::OpenPerms perms) noexcept {
+  OpenArgs args{.flags = static_cast<int>(flags) | O_NONBLOCK,
+                .perms = static_cast<int>(perms),
+                .path = {}};
+  if (!copy_path(args.path, path)) {
+    co_return Failure{SyscallError{ENAMETOOLONG}};
+  }
+  COROSIG_CO_TRY(long fd, co_await run(
+                              r,
+                              [](void *raw) noexcept -> long {
+                                auto *args = static_cast<OpenArgs *>(raw);
+                                return ::open(args->path.data(), args->flags, args->perms);
+                              },
+                              args));
+  co_return File::make_from_os_specific_handle(static_cast<os::Handle>(fd));
+}
+
+Fut<void, Error<AllocationError, SyscallError>> OffloadWorker::fsync(Reactor &r,
+                                                                    File const &file) noexcept {
+  os::Handle fd = file.underlying_handle();
+  COROSIG_CO_TRYV(co_await run(
+      r,
+      [](void *raw) noexcept -> long { return ::fsync(*static_cast<os::Handle *>(raw)); },
+      fd));
+  co_return Ok{};
+}
+
+Fut<void, Error<AllocationError, SyscallError>>
+OffloadWorker::stat(Reactor &r, char const *path, struct stat &out) noexcept {
+  StatArgs args{};
+  if (!copy_path(args.path, path)) {
+    co_return Failure{SyscallError{ENAMETOOLONG}};
+  }
+  COROSIG_CO_TRYV(co_await run(
+      r,
+      [](void *raw) noexcept -> long {
+        auto *args = static_cast<StatArgs *>(raw);
+        return ::stat(args->path.data(), &args->out);
+      },
+      args));
+  out = args.out;
+  co_return Ok{};
+}
+
+void *OffloadWorker::worker_main(void *self) noexcept {
+  static_cast<OffloadWorker *>(self)->serve();
+  return nullptr;
+}
+
+void OffloadWorker::serve() noexcept {
+#ifdef __linux__
+  while (true) {
+    uint32_t seen = m_sequence.load(std::memory_order_acquire);
+
+    for (Slot &slot : m_slots) {
+      SlotState state = slot.state.load(std::memory_order_acquire);
+      if (state == SlotState::ABANDONED) {
+        // Dropped before worker got to it
+        slot.state.store(SlotState::FREE, std::memory_order_release);
+        continue;
+      }
+      if (state != SlotState::SUBMITTED) {
+        continue;
+      }
+      errno = 0;
+      slot.result = slot.call(slot.args.data());
+      slot.error = slot.result == -1 ? errno : 0;
+      SlotState expected = SlotState::SUBMITTED;
+      if (!slot.state.compare_exchange_strong(expected, SlotState::DONE,
+                                              std::memory_order_acq_rel)) {
+        // Dropped while call was in flight, nobody waits for the result
+        slot.state.store(SlotState::FREE, std::memory_order_release);
+        continue;
+      }
+
+      uint64_t one = 1;
+      (void)::write(slot.done_fd, &one, sizeof(one));
+    }
+
+    if (m_stop.load()) {
+      return;
+    }
+    // Returns right away if anything was submitted since sequence was read
+    (void)::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_sequence), FUTEX_WAIT_PRIVATE,
+                    seen, nullptr, nullptr, 0);
+  }
+#endif
+}
+
+void OffloadWorker::wake() noexcept {
+  m_sequence.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+  (void)::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_sequence), FUTEX_WAKE_PRIVATE, 1,
+                  nullptr, nullptr, 0);
+#endif
+}
+
+} // namespace corosig
@@ -0,0 +1,74 @@
+#include "corosig/Sighandler.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstddef>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace corosig {
+
+namespace detail {
+
+Result<void, SyscallError> install_sigaction(int sig, void (*handler)(int)) noexcept {
+  struct sigaction action {};
+  action.sa_handler = handler;
+  // Handler state is shared between signals, so they must not interrupt each other. Resetting to
+  // default action avoids recursive calls if something goes wrong inside
+  action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+  ::sigfillset(&action.sa_mask);
+  if (::sigaction(sig, &action, nullptr) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return Ok{};
+}
+
+} // namespace detail
+
+Result<void, SyscallError> install_alt_stack(size_t size) noexcept {
+  stack_t current{};
+  if (::sigaltstack(nullptr, &current) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  if ((current.ss_flags & SS_DISABLE) == 0) {
+    return Ok{};
+  }
+
+  auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size = std::max(size, static_cast<size_t>(SIGSTKSZ));
+  size = (size + page - 1) / page * page;
+
+  void *mapping = ::mmap(nullptr, size + page, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    return Failure{SyscallError::current()};
+  }
+  // Stack grows down, so overflowing it hits the guard page instead of unrelated memory
+  if (::mprotect(mapping, page, PROT_NONE) == -1) {
+    SyscallError error = SyscallError::current();
+    ::munmap(mapping, size + page);
+    return Failure{error};
+  }
+
+  // Fault every page in now, so the handler neither takes page faults nor runs out of memory
+  // at crash time
+  auto *stack_begin = static_cast<char *>(mapping) + page;
+  for (size_t offset = 0; offset < size; offset += page) {
+    static_cast<char volatile *>(stack_begin)[offset] = 0;
+  }
+
+  stack_t stack{};
+  stack.ss_sp = stack_begin;
+  stack.ss_size = size;
+  if (::sigaltstack(&stack, nullptr) == -1) {
+    SyscallError error = SyscallError::current();
+    ::munmap(mapping, size + page);
+    return Failure{error};
+  }
+  return Ok{};
+}
+
+} // namespace corosig
@@ -0,0 +1,91 @@
+#include "corosig/SignalStream.hpp"
+
+#ifdef __linux__
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/PollEvent.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <pthread.h>
+#include <span>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+namespace corosig {
+
+Result<SignalStream, SyscallError> SignalStream::make(std::span<int const> signals) noexcept {
+  sigset_t mask;
+  ::sigemptyset(&mask);
+  for (int sig : signals) {
+    if (::sigaddset(&mask, sig) == -1) {
+      return Failure{SyscallError::current()};
+    }
+  }
+
+  sigset_t old;
+  if (int res = ::pthread_sigmask(SIG_BLOCK, &mask, &old); res != 0) {
+    return Failure{SyscallError{res}};
+  }
+
+  SignalStream stream;
+  ::sigemptyset(&stream.m_unblock);
+  for (int sig : signals) {
+    if (::sigismember(&old, sig) == 0) {
+      ::sigaddset(&stream.m_unblock, sig);
+    }
+  }
+
+  stream.m_fd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (stream.m_fd.value == -1) {
+    SyscallError error = SyscallError::current();
+    ::pthread_sigmask(SIG_UNBLOCK, &stream.m_unblock, nullptr);
+    return Failure{error};
+  }
+  return stream;
+}
+
+SignalStream::~SignalStream() {
+  close();
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+SignalStream::read(Reactor &, std::span<Info> infos) noexcept {
+  while (true) {
+    Result res = try_read(infos);
+    if (res.is_ok() || res.error().value != EAGAIN) {
+      co_return res;
+    }
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  }
+}
+
+Result<size_t, SyscallError> SignalStream::try_read(std::span<Info> infos) noexcept {
+  ssize_t n = ::read(m_fd.value, infos.data(), infos.size_bytes());
+  if (n == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(n) / sizeof(Info);
+}
+
+void SignalStream::close() noexcept {
+  if (m_fd.value == -1) {
+    return;
+  }
+  ::close(m_fd.value);
+  m_fd.value = -1;
+  ::pthread_sigmask(SIG_UNBLOCK, &m_unblock, nullptr);
+}
+
+os::Handle SignalStream::underlying_handle() const noexcept {
+  return m_fd.value;
+}
+
+} // namespace corosig
+
+#endif
@@ -149,7 +149,28 @@ size_t Allocator::current_memory() const noexcept {
   return m_used;
 }
 
+size_t Allocator::capacity() const noexcept {
+  return m_mem.size();
+}
+
+bool Allocator::owns(void const *ptr) const noexcept {
+  auto const *p = static_cast<char const *>(ptr);
+  return p >= m_mem.data() && p < m_mem.data() + m_mem.size();
+}
+
+void Allocator::set_observer(Observer *observer) noexcept {
+  m_observer = observer;
+}
+
 void *Allocator::allocate(size_t size, size_t alignment) noexcept {
+  void *result = allocate_impl(size, alignment);
+  if (m_observer != nullptr) [[unlikely]] {
+    m_observer->on_allocate(result, size, __builtin_return_address(0));
+  }
+  return result;
+}
+
+void *Allocator::allocate_impl(size_t size, size_t alignment) noexcept {
   assert(std::has_single_bit(alignment) && "Alignment must be a power of 2");
 
   for (size_t metadata_idx = m_first_free_block_idx; metadata_idx < blocks_amount();) {
@@ -227,6 +248,10 @@ void Allocator::deallocate(void *ptr) noexcept {
     return;
   }
 
+  if (m_observer != nullptr) [[unlikely]] {
+    m_observer->on_deallocate(ptr);
+  }
+
   assert(ptr >= &*m_mem.begin() && ptr < &*m_mem.end() &&
          "Given pointer is out of allocator's scope");
 
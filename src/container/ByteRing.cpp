@@ -0,0 +1,117 @@
+#include "corosig/container/ByteRing.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/container/Allocator.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace corosig {
+
+ByteRing::ByteRing(char *data, size_t capacity, Allocator *alloc) noexcept
+    : m_data{data},
+      m_capacity{capacity},
+      m_alloc{alloc},
+      m_mirrored{alloc == nullptr} {
+}
+
+Result<ByteRing, AllocationError> ByteRing::make(Allocator &alloc, size_t min_capacity) noexcept {
+  size_t capacity = std::bit_ceil(std::max<size_t>(min_capacity, 1));
+  auto *data = static_cast<char *>(alloc.allocate(capacity, alignof(std::max_align_t)));
+  if (data == nullptr) {
+    return Failure{AllocationError{}};
+  }
+  return ByteRing{data, capacity, &alloc};
+}
+
+Result<ByteRing, SyscallError> ByteRing::make_mirrored(size_t min_capacity) noexcept {
+#ifdef __linux__
+  auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t capacity = std::bit_ceil(std::max(min_capacity, page_size));
+
+  int fd = ::memfd_create("corosig-byte-ring", MFD_CLOEXEC);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+
+  // reserve an address range for both copies first, so that nothing else can be mapped in between
+  void *reserved = MAP_FAILED;
+  SyscallError error;
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) == -1) {
+    error = SyscallError::current();
+  } else {
+    reserved = ::mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+      error = SyscallError::current();
+    }
+  }
+
+  auto *data = static_cast<char *>(reserved);
+  if (reserved != MAP_FAILED) {
+    for (char *half : {data, data + capacity}) {
+      if (::mmap(half, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ==
+          MAP_FAILED) {
+        error = SyscallError::current();
+        ::munmap(reserved, capacity * 2);
+        reserved = MAP_FAILED;
+        break;
+      }
+    }
+  }
+
+  // mappings keep the memory alive on their own
+  ::close(fd);
+  if (reserved == MAP_FAILED) {
+    return Failure{error};
+  }
+  return ByteRing{data, capacity, nullptr};
+#else
+  (void)min_capacity;
+  return Failure{SyscallError{ENOSYS}};
+#endif
+}
+
+ByteRing::ByteRing(ByteRing &&rhs) noexcept
+    : m_data{std::exchange(rhs.m_data, nullptr)},
+      m_capacity{std::exchange(rhs.m_capacity, 0)},
+      m_head{std::exchange(rhs.m_head, 0)},
+      m_tail{std::exchange(rhs.m_tail, 0)},
+      m_alloc{std::exchange(rhs.m_alloc, nullptr)},
+      m_mirrored{std::exchange(rhs.m_mirrored, false)} {
+}
+
+ByteRing &ByteRing::operator=(ByteRing &&rhs) noexcept {
+  if (this != &rhs) {
+    this->~ByteRing();
+    new (this) ByteRing{std::move(rhs)};
+  }
+  return *this;
+}
+
+ByteRing::~ByteRing() {
+  release();
+}
+
+void ByteRing::release() noexcept {
+  if (m_data == nullptr) {
+    return;
+  }
+  if (m_mirrored) {
+#ifdef __linux__
+    ::munmap(m_data, m_capacity * 2);
+#endif
+  } else {
+    m_alloc->deallocate(m_data);
+  }
+  m_data = nullptr;
+}
+
+} // namespace corosig
@@ -0,0 +1,89 @@
+#include "corosig/container/NewInterposition.hpp"
+
+#include "corosig/container/Allocator.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+using namespace corosig;
+
+// thread_local, since other threads keep using the global heap while a handler runs
+thread_local ScopedNewInterposition *g_active_interposition = nullptr; // NOLINT
+
+} // namespace
+
+namespace corosig {
+
+ScopedNewInterposition::ScopedNewInterposition(Allocator &alloc) noexcept
+    : m_alloc{alloc},
+      m_previous{g_active_interposition} {
+  g_active_interposition = this;
+}
+
+ScopedNewInterposition::~ScopedNewInterposition() {
+  g_active_interposition = m_previous;
+}
+
+size_t ScopedNewInterposition::allocations() const noexcept {
+  return m_allocations;
+}
+
+size_t ScopedNewInterposition::allocated_bytes() const noexcept {
+  return m_allocated_bytes;
+}
+
+size_t ScopedNewInterposition::failed_allocations() const noexcept {
+  return m_failed_allocations;
+}
+
+namespace detail {
+
+void *interposed_new(size_t size, size_t alignment) noexcept {
+  size = size == 0 ? 1 : size;
+
+  ScopedNewInterposition *active = g_active_interposition;
+  if (active == nullptr) {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return std::malloc(size); // NOLINT(cppcoreguidelines-no-malloc)
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+
+  void *result = active->m_alloc.allocate(size, alignment);
+  if (result == nullptr) {
+    ++active->m_failed_allocations;
+  } else {
+    ++active->m_allocations;
+    active->m_allocated_bytes += size;
+  }
+  return result;
+}
+
+void *interposed_new_or_throw(size_t size, size_t alignment) {
+  void *result = interposed_new(size, alignment);
+  if (result == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return result;
+}
+
+void interposed_delete(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  for (ScopedNewInterposition *it = g_active_interposition; it != nullptr; it = it->m_previous) {
+    if (it->m_alloc.owns(ptr)) {
+      it->m_alloc.deallocate(ptr);
+      return;
+    }
+  }
+  std::free(ptr); // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+} // namespace detail
+
+} // namespace corosig
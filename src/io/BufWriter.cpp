@@ -0,0 +1,32 @@
+#include "corosig/io/BufWriter.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Stdio.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "posix/FdOps.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+
+namespace corosig::detail {
+
+static_assert(std::output_iterator<BufWriter<StdOut>::OutputIterator, char const &>);
+static_assert(BufWriterSink<File> && SinkWithHandle<File>);
+static_assert(BufWriterSink<TcpSocket> && SinkWithHandle<TcpSocket>);
+static_assert(BufWriterSink<PipeWrite> && SinkWithHandle<PipeWrite>);
+
+Fut<void, Error<AllocationError, SyscallError>>
+write_vectored(Reactor &r,
+               os::Handle fd,
+               std::span<std::span<char const> const> bufs,
+               size_t &written) noexcept {
+  return os::posix::write_vectored(r, fd, bufs, written);
+}
+
+} // namespace corosig::detail
@@ -0,0 +1,93 @@
+#include "corosig/io/Copy.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Stdio.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/io/Transfer.hpp"
+#include "corosig/io/UnixSocket.hpp"
+#include "corosig/meta/AsyncIo.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
+
+namespace {
+
+using namespace corosig;
+
+/// Amount of bytes asked from the kernel at once by zero-copy transfers
+constexpr size_t TRANSFER_CHUNK = size_t{1} << 20;
+
+/// Errors which mean that zero-copy transfer is not possible between these ends at all
+bool is_unsupported(Error<AllocationError, SyscallError> const &error) noexcept {
+  if (!error.holds<SyscallError>()) {
+    return false;
+  }
+  int value = error.as<SyscallError>().value;
+  return value == ENOSYS || value == EINVAL || value == EOPNOTSUPP;
+}
+
+} // namespace
+
+namespace corosig {
+
+static_assert(AsyncRead<File> && AsyncWrite<File>);
+static_assert(AsyncRead<PipeRead> && AsyncWrite<PipeWrite>);
+static_assert(AsyncRead<TcpSocket> && AsyncWrite<TcpSocket>);
+static_assert(AsyncRead<UnixStream> && AsyncWrite<UnixStream>);
+static_assert(AsyncRead<StdIn> && AsyncWrite<StdOut>);
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+copy(Reactor &r, File &from, TcpSocket &to, size_t buffer_budget) noexcept {
+  off_t offset = ::lseek(from.underlying_handle(), 0, SEEK_CUR);
+  if (offset == -1) {
+    co_return co_await copy<File, TcpSocket>(r, from, to, buffer_budget);
+  }
+
+  size_t copied = 0;
+  while (true) {
+    auto sent = co_await transfer(r, from, to, static_cast<uint64_t>(offset) + copied,
+                                  TRANSFER_CHUNK);
+    if (!sent) {
+      if (copied == 0 && is_unsupported(sent.error())) {
+        co_return co_await copy<File, TcpSocket>(r, from, to, buffer_budget);
+      }
+      // Bytes which have already reached the socket must not be sent again by a retry
+      ::lseek(from.underlying_handle(), offset + static_cast<off_t>(copied), SEEK_SET);
+      co_return Failure{std::move(sent.error())};
+    }
+    if (sent.value() == 0) {
+      break;
+    }
+    copied += sent.value();
+  }
+
+  ::lseek(from.underlying_handle(), offset + static_cast<off_t>(copied), SEEK_SET);
+  co_return copied;
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+copy(Reactor &r, PipeRead &from, PipeWrite &to, size_t buffer_budget) noexcept {
+  size_t copied = 0;
+  while (true) {
+    auto moved = co_await transfer(r, from, to, TRANSFER_CHUNK);
+    if (!moved) {
+      if (copied == 0 && is_unsupported(moved.error())) {
+        co_return co_await copy<PipeRead, PipeWrite>(r, from, to, buffer_budget);
+      }
+      co_return Failure{std::move(moved.error())};
+    }
+    if (moved.value() == 0) {
+      break;
+    }
+    copied += moved.value();
+  }
+  co_return copied;
+}
+
+} // namespace corosig
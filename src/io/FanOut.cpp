@@ -0,0 +1,37 @@
+#include "corosig/io/FanOut.hpp"
+
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Stdio.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/io/UdpSocket.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace corosig::detail {
+
+static_assert(DatagramSink<UdpSocket>);
+static_assert(!DatagramSink<File> && SinkWithHandle<File>);
+static_assert(!DatagramSink<TcpSocket> && SinkWithHandle<TcpSocket>);
+static_assert(!DatagramSink<StdOut> && SinkWithHandle<StdOut>);
+
+size_t gather_chunks(std::span<std::span<char const> const> source,
+                     size_t skip,
+                     std::span<std::span<char const>> out) noexcept {
+  size_t count = 0;
+  for (std::span<char const> chunk : source) {
+    if (count == out.size()) {
+      break;
+    }
+    if (skip >= chunk.size()) {
+      skip -= chunk.size();
+      continue;
+    }
+    out[count++] = chunk.subspan(skip);
+    skip = 0;
+  }
+  return count;
+}
+
+} // namespace corosig::detail
@@ -2,16 +2,65 @@
 
 #include "corosig/Coro.hpp"
 #include "corosig/ErrorTypes.hpp"
+#include "corosig/Parallel.hpp"
+#include "corosig/PollEvent.hpp"
 #include "corosig/Result.hpp"
+#include "corosig/Yield.hpp"
 #include "corosig/os/Handle.hpp"
 #include "corosig/reactor/Reactor.hpp"
 #include "posix/FdOps.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <fcntl.h>
 #include <span>
+#include <sys/uio.h>
 #include <unistd.h>
 
+namespace {
+
+using namespace corosig;
+
+Result<void, SyscallError> start_writeback(int fd) noexcept {
+#ifdef SYNC_FILE_RANGE_WRITE
+  if (::sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE) == -1) {
+    return Failure{SyscallError::current()};
+  }
+#else
+  (void)fd;
+#endif
+  return Ok{};
+}
+
+Result<void, SyscallError> wait_for_storage(int fd, File::Durability durability) noexcept {
+  int result = 0;
+  switch (durability) {
+  case File::Durability::NONE:
+  case File::Durability::WRITE_BEHIND:
+    break;
+  case File::Durability::DATA:
+    result = ::fdatasync(fd);
+    break;
+  case File::Durability::FULL:
+    result = ::fsync(fd);
+    break;
+  }
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return Ok{};
+}
+
+struct WriteRange {
+  File *file;
+  std::span<char const> data;
+  uint64_t offset;
+};
+
+} // namespace
+
 namespace corosig {
 
 File::~File() {
@@ -46,13 +95,172 @@ Result<size_t, SyscallError> File::try_write_some(std::span<char const> buf) noe
   return os::posix::try_write_some(m_fd.value, buf);
 }
 
+Fut<size_t, Error<AllocationError, SyscallError>>
+File::read_at(Reactor &, std::span<char> buf, uint64_t offset) noexcept {
+  size_t read = 0;
+  while (read < buf.size()) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+    Result current_read = try_read_some_at(buf.subspan(read), offset + read);
+    if (current_read.is_ok()) {
+      if (current_read.value() == 0) {
+        break;
+      }
+      read += current_read.value();
+    } else if (read == 0) {
+      co_return Failure{current_read.error()};
+    } else {
+      break;
+    }
+  }
+  co_return read;
+}
+
+Result<size_t, SyscallError> File::try_read_some_at(std::span<char> buf,
+                                                    uint64_t offset) noexcept {
+  ssize_t n = ::pread(m_fd.value, buf.data(), buf.size(), static_cast<off_t>(offset));
+  if (n == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(n);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+File::read_vectored_at(Reactor &, std::span<std::span<char> const> bufs, uint64_t offset) noexcept {
+  size_t total = os::posix::total_size(bufs);
+  size_t read = 0;
+  while (read < total) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+
+    std::array<iovec, os::posix::MAX_VECTORED_BUFFERS> iov;
+    size_t iov_count = os::posix::gather(bufs, read, iov);
+    ssize_t n = ::preadv(
+        m_fd.value, iov.data(), static_cast<int>(iov_count), static_cast<off_t>(offset + read));
+    if (n == -1) {
+      if (read == 0) {
+        co_return Failure{SyscallError::current()};
+      }
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    read += static_cast<size_t>(n);
+  }
+  co_return read;
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+File::write_at(Reactor &, std::span<char const> buf, uint64_t offset) noexcept {
+  size_t written = 0;
+  while (written < buf.size()) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+    Result current_write = try_write_some_at(buf.subspan(written), offset + written);
+    if (current_write.is_ok()) {
+      written += current_write.value();
+    } else if (written == 0) {
+      co_return Failure{current_write.error()};
+    } else {
+      break;
+    }
+  }
+  co_return written;
+}
+
+Result<size_t, SyscallError> File::try_write_some_at(std::span<char const> buf,
+                                                     uint64_t offset) noexcept {
+  ssize_t n = ::pwrite(m_fd.value, buf.data(), buf.size(), static_cast<off_t>(offset));
+  if (n == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(n);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> File::write_vectored_at(
+    Reactor &, std::span<std::span<char const> const> bufs, uint64_t offset) noexcept {
+  size_t total = os::posix::total_size(bufs);
+  size_t written = 0;
+  while (written < total) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+
+    std::array<iovec, os::posix::MAX_VECTORED_BUFFERS> iov;
+    size_t iov_count = os::posix::gather(bufs, written, iov);
+    ssize_t n = ::pwritev(
+        m_fd.value, iov.data(), static_cast<int>(iov_count), static_cast<off_t>(offset + written));
+    if (n == -1) {
+      if (written == 0) {
+        co_return Failure{SyscallError::current()};
+      }
+      break;
+    }
+    written += static_cast<size_t>(n);
+  }
+  co_return written;
+}
+
+Fut<void, Error<AllocationError, SyscallError>> File::write_at_parallel(Reactor &r,
+                                                                         std::span<char const> data,
+                                                                         uint64_t offset,
+                                                                         size_t ranges) noexcept {
+  ranges = std::clamp<size_t>(ranges, 1, MAX_PARALLEL_RANGES);
+  size_t range_size = (data.size() + ranges - 1) / ranges;
+
+  std::array<WriteRange, MAX_PARALLEL_RANGES> storage;
+  size_t count = 0;
+  for (size_t begin = 0; begin < data.size(); begin += range_size) {
+    size_t size = std::min(range_size, data.size() - begin);
+    storage[count++] = WriteRange{this, data.subspan(begin, size), offset + begin};
+  }
+
+  co_return co_await parallel_foreach(
+      r,
+      std::span{storage}.first(count),
+      [](Reactor &r, WriteRange range) -> Fut<void, Error<AllocationError, SyscallError>> {
+        // write_at stops short only on error, so the next attempt reports it
+        while (!range.data.empty()) {
+          COROSIG_CO_TRY(size_t written,
+                         co_await range.file->write_at(r, range.data, range.offset));
+          range.data = range.data.subspan(written);
+          range.offset += written;
+        }
+        co_return Ok{};
+      });
+}
+
+Fut<void, Error<AllocationError, SyscallError>> File::sync(Reactor &) noexcept {
+  if (m_durability == Durability::NONE) {
+    co_return Ok{};
+  }
+
+  COROSIG_CO_TRYV(start_writeback(m_fd.value));
+  if (m_durability != Durability::WRITE_BEHIND) {
+    co_await Yield{};
+    COROSIG_CO_TRYV(wait_for_storage(m_fd.value, m_durability));
+  }
+  co_return Ok{};
+}
+
+void File::set_durability(Durability durability) noexcept {
+  m_durability = durability;
+}
+
+File::Durability File::durability() const noexcept {
+  return m_durability;
+}
+
 os::Handle File::underlying_handle() const noexcept {
   return m_fd.value;
 }
 
 void File::close() noexcept {
   if (m_fd.value >= 0) {
-    ::fsync(m_fd.value);
+    if (m_writable) {
+      // Nobody to report an error to. Use sync to handle them
+      if (m_durability == Durability::WRITE_BEHIND) {
+        (void)start_writeback(m_fd.value);
+      } else {
+        (void)wait_for_storage(m_fd.value, m_durability);
+      }
+    }
     ::close(m_fd.value);
     m_fd.value = -1;
   }
@@ -61,9 +269,17 @@ void File::close() noexcept {
 File File::make_from_os_specific_handle(os::Handle handle) noexcept {
   File file;
   file.m_fd = handle;
+  // Whoever holds the handle may write through it bypassing File, e.g. BufWriter or fan_out, so
+  // access mode is the only reliable sign that there may be something to make durable
+  int flags = ::fcntl(handle, F_GETFL);
+  file.m_writable = flags == -1 || (flags & O_ACCMODE) != O_RDONLY;
   return file;
 }
 
+bool File::syncs_on_close() const noexcept {
+  return m_fd.value >= 0 && m_writable && m_durability != Durability::NONE;
+}
+
 Fut<File, Error<AllocationError, SyscallError>>
 File::open(Reactor &, char const *path, OpenFlags flags, OpenPerms perms) noexcept {
   // Actually a blocking open. Future is used as interface in order to provide capability for other
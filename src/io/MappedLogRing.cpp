@@ -0,0 +1,163 @@
+#include "corosig/io/MappedLogRing.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <span>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace corosig {
+
+/// Lives at the beginning of the file. Data follows it starting from the next page
+struct MappedLogRing::Header {
+  constexpr static uint64_t MAGIC = 0x676e69526c736f63; // "coslRing"
+
+  uint64_t magic = MAGIC;
+  uint64_t capacity;
+  /// Bytes ever reserved by appends
+  std::atomic<uint64_t> reserved = 0;
+  /// Bytes ever fully copied by appends
+  std::atomic<uint64_t> committed = 0;
+  /// Value of reserved at the last seal
+  std::atomic<uint64_t> sealed = 0;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Ring is shared through a file, so its counters can not take a lock");
+
+MappedLogRing::MappedLogRing(Header *header, size_t capacity) noexcept
+    : m_header{header},
+      m_data{reinterpret_cast<char *>(header) + ::sysconf(_SC_PAGESIZE)},
+      m_capacity{capacity} {
+}
+
+Result<MappedLogRing, SyscallError> MappedLogRing::open(Options const &options) noexcept {
+  auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t capacity = std::bit_ceil(std::max(options.min_capacity, page_size));
+  size_t file_size = page_size + capacity;
+
+  int fd = ::open(options.path, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+
+  struct stat st {};
+  void *mapping = MAP_FAILED;
+  SyscallError error;
+  if (::fstat(fd, &st) == -1) {
+    error = SyscallError::current();
+  } else if (static_cast<size_t>(st.st_size) != file_size &&
+             ::ftruncate(fd, static_cast<off_t>(file_size)) == -1) {
+    error = SyscallError::current();
+  } else {
+    mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      error = SyscallError::current();
+    }
+  }
+
+  // mapping keeps the file alive on its own
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return Failure{error};
+  }
+
+  auto *header = static_cast<Header *>(mapping);
+  bool reusable = options.keep_contents && static_cast<size_t>(st.st_size) == file_size &&
+                  header->magic == Header::MAGIC && header->capacity == capacity;
+  if (!reusable) {
+    new (header) Header{.capacity = capacity};
+  }
+  return MappedLogRing{header, capacity};
+}
+
+MappedLogRing::MappedLogRing(MappedLogRing &&rhs) noexcept
+    : m_header{std::exchange(rhs.m_header, nullptr)},
+      m_data{std::exchange(rhs.m_data, nullptr)},
+      m_capacity{std::exchange(rhs.m_capacity, 0)} {
+}
+
+MappedLogRing &MappedLogRing::operator=(MappedLogRing &&rhs) noexcept {
+  if (this != &rhs) {
+    this->~MappedLogRing();
+    new (this) MappedLogRing{std::move(rhs)};
+  }
+  return *this;
+}
+
+MappedLogRing::~MappedLogRing() {
+  release();
+}
+
+size_t MappedLogRing::mapping_size() const noexcept {
+  return static_cast<size_t>(m_data - reinterpret_cast<char *>(m_header)) + m_capacity;
+}
+
+void MappedLogRing::release() noexcept {
+  if (m_header == nullptr) {
+    return;
+  }
+  ::munmap(m_header, mapping_size());
+  m_header = nullptr;
+}
+
+void MappedLogRing::append(std::span<char const> data) noexcept {
+  if (data.size() > m_capacity) {
+    data = data.last(m_capacity);
+  }
+
+  uint64_t begin = m_header->reserved.fetch_add(data.size(), std::memory_order_relaxed);
+  size_t offset = begin & (m_capacity - 1);
+  size_t first = std::min(data.size(), m_capacity - offset);
+  std::memcpy(m_data + offset, data.data(), first);
+  std::memcpy(m_data, data.data() + first, data.size() - first);
+  m_header->committed.fetch_add(data.size(), std::memory_order_release);
+}
+
+bool MappedLogRing::seal() noexcept {
+  uint64_t end = m_header->reserved.load(std::memory_order_acquire);
+  bool complete = m_header->committed.load(std::memory_order_acquire) == end;
+  m_header->sealed.store(end, std::memory_order_release);
+  return complete;
+}
+
+uint64_t MappedLogRing::sealed() const noexcept {
+  return m_header->sealed.load(std::memory_order_acquire);
+}
+
+Result<void, SyscallError> MappedLogRing::sync(bool wait) noexcept {
+  if (::msync(m_header, mapping_size(), wait ? MS_SYNC : MS_ASYNC) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return Ok{};
+}
+
+std::array<std::span<char const>, 2> MappedLogRing::readable_parts() const noexcept {
+  uint64_t end_pos = end();
+  size_t length = size();
+  size_t offset = (end_pos - length) & (m_capacity - 1);
+  size_t first = std::min(length, m_capacity - offset);
+  return {std::span<char const>{m_data + offset, first},
+          std::span<char const>{m_data, length - first}};
+}
+
+uint64_t MappedLogRing::end() const noexcept {
+  return m_header->reserved.load(std::memory_order_acquire);
+}
+
+size_t MappedLogRing::size() const noexcept {
+  return static_cast<size_t>(std::min<uint64_t>(end(), m_capacity));
+}
+
+} // namespace corosig
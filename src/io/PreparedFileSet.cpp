@@ -0,0 +1,97 @@
+#include "corosig/io/PreparedFileSet.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/io/File.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <fcntl.h>
+#include <span>
+#include <unistd.h>
+
+namespace {
+
+using namespace corosig;
+
+Result<File, SyscallError>
+prepare_file(char const *path, size_t size, File::OpenPerms perms) noexcept {
+  int fd = ::open(path,
+                  O_CREAT | O_TRUNC | O_WRONLY | O_NONBLOCK | O_CLOEXEC,
+                  static_cast<int>(perms));
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+  File file = File::make_from_os_specific_handle(fd);
+
+#ifdef __linux__
+  // Blocks are allocated past the end of file, so it stays empty and its size is what was written
+  if (::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == -1) {
+    return Failure{SyscallError::current()};
+  }
+#else
+  // Unlike errno-reporting calls, posix_fallocate returns an error
+  if (int err = ::posix_fallocate(fd, 0, static_cast<off_t>(size)); err != 0) {
+    return Failure{SyscallError{err}};
+  }
+#endif
+  return file;
+}
+
+} // namespace
+
+namespace corosig {
+
+PreparedFileSet::~PreparedFileSet() {
+  (void)close();
+}
+
+Result<void, SyscallError> PreparedFileSet::prepare(Options const &options) noexcept {
+  COROSIG_TRYV(close());
+
+  for (char const *path : options.paths.first(std::min(options.paths.size(), MAX_FILES))) {
+    Result file = prepare_file(path, options.reserve_size, options.perms);
+    if (!file) {
+      (void)close();
+      return Failure{file.error()};
+    }
+    m_files[m_size++] = std::move(file.value());
+  }
+  return Ok{};
+}
+
+File *PreparedFileSet::acquire() noexcept {
+  size_t index = m_next.fetch_add(1);
+  if (index >= m_size) {
+    return nullptr;
+  }
+  return &m_files[index];
+}
+
+size_t PreparedFileSet::available() const noexcept {
+  return m_size - std::min(m_next.load(), m_size);
+}
+
+size_t PreparedFileSet::size() const noexcept {
+  return m_size;
+}
+
+Result<void, SyscallError> PreparedFileSet::close() noexcept {
+  Result<void, SyscallError> result = Ok{};
+  for (File &file : std::span{m_files}.first(m_size)) {
+    int fd = file.underlying_handle();
+    if (fd == -1) {
+      continue;
+    }
+    off_t written = ::lseek(fd, 0, SEEK_CUR);
+    if ((written == -1 || ::ftruncate(fd, written) == -1) && result.is_ok()) {
+      result = Failure{SyscallError::current()};
+    }
+    file.close();
+  }
+  m_size = 0;
+  m_next.store(0);
+  return result;
+}
+
+} // namespace corosig
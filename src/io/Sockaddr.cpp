@@ -14,6 +14,7 @@
 #include <span>
 #include <string_view>
 #include <sys/socket.h>
+#include <sys/un.h>
 
 namespace {
 
@@ -305,4 +306,40 @@ SockaddrStorage IpvNAddr::to_sockaddr(uint16_t port) const noexcept {
   return visit([&](auto const &addr) { return addr.to_sockaddr(port); });
 }
 
+std::optional<UnixAddr> UnixAddr::from_path(std::string_view path) noexcept {
+  if (path.empty() || path.size() > MAX_NAME_SIZE || path.find('\0') != std::string_view::npos) {
+    return std::nullopt;
+  }
+  UnixAddr addr;
+  std::ranges::copy(path, addr.m_name.begin());
+  addr.m_size = static_cast<uint8_t>(path.size());
+  return addr;
+}
+
+std::optional<UnixAddr> UnixAddr::abstract(std::string_view name) noexcept {
+  std::optional addr = from_path(name);
+  if (addr) {
+    addr->m_abstract = true;
+  }
+  return addr;
+}
+
+SockaddrStorage UnixAddr::to_sockaddr() const noexcept {
+  static_assert(sizeof(sockaddr_un::sun_path) > MAX_NAME_SIZE);
+
+  SockaddrStorage sockaddr;
+  auto *result = reinterpret_cast<sockaddr_un *>(&sockaddr.native_storage);
+  result->sun_family = AF_UNIX;
+  std::ranges::copy(name(), result->sun_path + static_cast<size_t>(m_abstract));
+  return sockaddr;
+}
+
+std::string_view UnixAddr::name() const noexcept {
+  return std::string_view{m_name.data(), m_size};
+}
+
+bool UnixAddr::is_abstract() const noexcept {
+  return m_abstract;
+}
+
 } // namespace corosig
@@ -0,0 +1,163 @@
+#include "corosig/io/TcpConnectionPool.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/Sleep.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/TcpSocket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <span>
+#include <sys/socket.h>
+
+namespace {
+
+using namespace corosig;
+
+/// Connection is considered alive unless peer has shut it down or it is in an error state
+bool is_alive(TcpSocket const &sock) noexcept {
+  // Called from signal handlers, which must leave errno of the interrupted code intact
+  int saved_errno = errno;
+  char byte = 0;
+  ssize_t res = ::recv(sock.underlying_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  int probe_errno = errno;
+  errno = saved_errno;
+  if (res != -1) {
+    return res > 0;
+  }
+  return probe_errno == EAGAIN || probe_errno == EWOULDBLOCK || probe_errno == EINTR;
+}
+
+void enable_keepalive(TcpSocket const &sock, std::chrono::seconds idle) noexcept {
+  int fd = sock.underlying_handle();
+  int on = 1;
+  // Not a hard failure. Dead connections are still noticed by checkout, just later
+  (void)::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+#ifdef TCP_KEEPIDLE
+  auto seconds = static_cast<int>(idle.count());
+  (void)::setsockopt(fd, SOL_TCP, TCP_KEEPIDLE, &seconds, sizeof(seconds));
+  (void)::setsockopt(fd, SOL_TCP, TCP_KEEPINTVL, &seconds, sizeof(seconds));
+#else
+  (void)idle;
+#endif
+}
+
+} // namespace
+
+namespace corosig {
+
+TcpConnectionPool::TcpConnectionPool(Options options) noexcept
+    : m_target{options.target},
+      m_size{std::min(options.size, MAX_CONNECTIONS)},
+      m_keepalive_idle{options.keepalive_idle} {
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> TcpConnectionPool::refill(Reactor &r) noexcept {
+  size_t ready = 0;
+  Error<AllocationError, SyscallError> last_error{SyscallError{ENOTCONN}};
+
+  for (Slot &slot : std::span{m_slots}.first(m_size)) {
+    SlotState state = slot.state.load();
+    if (state == SlotState::BUSY || !slot.state.compare_exchange_strong(state, SlotState::BUSY)) {
+      continue;
+    }
+
+    if (state == SlotState::READY) {
+      if (is_alive(slot.socket)) {
+        slot.state.store(SlotState::READY);
+        ++ready;
+        continue;
+      }
+      slot.socket.close();
+    }
+
+    // Slot stays BUSY while connecting, so a signal handler interrupting us just skips it. It is
+    // emptied again if connect fails or this future is dropped, as maintain is to be stopped
+    struct EmptyGuard {
+      Slot *slot;
+
+      ~EmptyGuard() {
+        if (slot != nullptr) {
+          slot->state.store(SlotState::EMPTY);
+        }
+      }
+    } guard{&slot};
+
+    auto connected = co_await TcpSocket::connect(r, m_target);
+    if (!connected) {
+      last_error = std::move(connected.error());
+      continue;
+    }
+
+    if (m_keepalive_idle != std::chrono::seconds{0}) {
+      enable_keepalive(connected.value(), m_keepalive_idle);
+    }
+    slot.socket = std::move(connected.value());
+    slot.state.store(SlotState::READY);
+    guard.slot = nullptr;
+    ++ready;
+  }
+
+  if (ready == 0 && m_size != 0) {
+    co_return Failure{std::move(last_error)};
+  }
+  co_return ready;
+}
+
+Fut<void> TcpConnectionPool::maintain(Reactor &r, std::chrono::milliseconds interval) noexcept {
+  while (true) {
+    // Nothing to do with a failure but to try again later, which the loop does anyway
+    (void)co_await refill(r);
+    co_await Sleep{interval};
+  }
+}
+
+Result<TcpSocket, SyscallError> TcpConnectionPool::checkout() noexcept {
+  for (Slot &slot : std::span{m_slots}.first(m_size)) {
+    SlotState expected = SlotState::READY;
+    if (!slot.state.compare_exchange_strong(expected, SlotState::BUSY)) {
+      continue;
+    }
+
+    TcpSocket sock = std::move(slot.socket);
+    slot.state.store(SlotState::EMPTY);
+    if (is_alive(sock)) {
+      return sock;
+    }
+  }
+  return Failure{SyscallError{ENOTCONN}};
+}
+
+void TcpConnectionPool::checkin(TcpSocket sock) noexcept {
+  if (sock.underlying_handle() == -1) {
+    return;
+  }
+
+  for (Slot &slot : std::span{m_slots}.first(m_size)) {
+    SlotState expected = SlotState::EMPTY;
+    if (slot.state.compare_exchange_strong(expected, SlotState::BUSY)) {
+      slot.socket = std::move(sock);
+      slot.state.store(SlotState::READY);
+      return;
+    }
+  }
+}
+
+size_t TcpConnectionPool::ready() const noexcept {
+  return static_cast<size_t>(
+      std::ranges::count_if(std::span{m_slots}.first(m_size), [](Slot const &slot) {
+        return slot.state.load() == SlotState::READY;
+      }));
+}
+
+size_t TcpConnectionPool::size() const noexcept {
+  return m_size;
+}
+
+} // namespace corosig
@@ -9,10 +9,14 @@
 #include "corosig/reactor/Reactor.hpp"
 #include "posix/FdOps.hpp"
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstddef>
 #include <fcntl.h>
 #include <limits>
 #include <netinet/tcp.h>
+#include <span>
 #include <sys/socket.h>
 
 namespace corosig {
@@ -35,6 +39,29 @@ Result<TcpListener, SyscallError> TcpListener::make(Options options) noexcept {
     return Failure{SyscallError::current()};
   }
 
+  if (options.defer_accept != std::chrono::seconds{0}) {
+#ifdef TCP_DEFER_ACCEPT
+    auto defer_accept = static_cast<int>(options.defer_accept.count());
+    if (::setsockopt(fd, SOL_TCP, TCP_DEFER_ACCEPT, &defer_accept, sizeof(defer_accept)) != 0) {
+      return Failure{SyscallError::current()};
+    }
+#else
+    return Failure{SyscallError{ENOSYS}};
+#endif
+  }
+
+  if (options.fastopen_queue_size != 0) {
+#ifdef TCP_FASTOPEN
+    auto queue_size = static_cast<int>(
+        std::min<size_t>(options.fastopen_queue_size, std::numeric_limits<int>::max()));
+    if (::setsockopt(fd, SOL_TCP, TCP_FASTOPEN, &queue_size, sizeof(queue_size)) != 0) {
+      return Failure{SyscallError::current()};
+    }
+#else
+    return Failure{SyscallError{ENOSYS}};
+#endif
+  }
+
   if (::bind(fd,
              reinterpret_cast<sockaddr const *>(&options.addr),
              os::posix::addr_length(options.addr.native_storage)) != 0) {
@@ -77,9 +104,18 @@ Result<AcceptResult, SyscallError> TcpListener::try_accept() noexcept {
   AcceptResult result;
 
   socklen_t incoming_addr_len = sizeof(SockaddrStorage);
-  int fd = ::accept(m_fd.value,
-                    reinterpret_cast<sockaddr *>(&result.incoming_connection_addr.native_storage),
-                    &incoming_addr_len);
+  auto *incoming_addr =
+      reinterpret_cast<sockaddr *>(&result.incoming_connection_addr.native_storage);
+
+#ifdef __linux__
+  int fd = ::accept4(m_fd.value, incoming_addr, &incoming_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+
+  result.incoming_connection = TcpSocket::make_from_os_specific_handle(fd);
+#else
+  int fd = ::accept(m_fd.value, incoming_addr, &incoming_addr_len);
   if (fd == -1) {
     return Failure{SyscallError::current()};
   }
@@ -95,6 +131,11 @@ Result<AcceptResult, SyscallError> TcpListener::try_accept() noexcept {
     return Failure{SyscallError::current()};
   }
 
+  if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+    return Failure{SyscallError::current()};
+  }
+#endif
+
   int on = 1;
   // Not a hard failure. Just a little bit of performance loss
   (void)::setsockopt(fd, SOL_TCP, TCP_NODELAY, &on, sizeof(on));
@@ -102,6 +143,39 @@ Result<AcceptResult, SyscallError> TcpListener::try_accept() noexcept {
   return result;
 }
 
+Fut<size_t, Error<AllocationError, SyscallError>>
+TcpListener::accept_batch(Reactor &, std::span<AcceptResult> out) noexcept {
+  if (out.empty()) {
+    co_return size_t{0};
+  }
+
+  while (true) {
+    auto res = try_accept_batch(out);
+    if (res || (res.error().value != EWOULDBLOCK && res.error().value != EINTR)) {
+      co_return std::move(res);
+    }
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  }
+}
+
+Result<size_t, SyscallError> TcpListener::try_accept_batch(std::span<AcceptResult> out) noexcept {
+  size_t accepted = 0;
+  for (AcceptResult &slot : out) {
+    auto res = try_accept();
+    if (!res) {
+      // Connection which has failed is not lost for already accepted ones. Error will be
+      // reported again on next attempt if it is persistent
+      if (accepted == 0) {
+        return Failure{res.error()};
+      }
+      break;
+    }
+    slot = std::move(res.value());
+    ++accepted;
+  }
+  return accepted;
+}
+
 Result<SockaddrStorage, SyscallError> TcpListener::address() const noexcept {
   return os::posix::socket_address(m_fd.value);
 }
@@ -21,6 +21,18 @@ namespace {
 
 using namespace corosig;
 
+Result<void, SyscallError> pending_connect_result(int fd) noexcept {
+  int socket_error = 0;
+  socklen_t socket_error_len = sizeof(socket_error);
+  if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_len) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  if (socket_error != 0) {
+    return Failure{SyscallError{socket_error}};
+  }
+  return Ok{};
+}
+
 Fut<TcpSocket, Error<AllocationError, SyscallError>>
 connect_impl(Reactor &r, SockaddrStorage const &target, TcpSocket sock) noexcept {
   auto len = os::posix::addr_length(target.native_storage);
@@ -40,16 +52,50 @@ connect_impl(Reactor &r, SockaddrStorage const &target, TcpSocket sock) noexcept
   co_await PollEvent{sock.underlying_handle(),
                      PollEventExpectance::CAN_WRITE | PollEventExpectance::CAN_READ};
 
-  int socket_error = 0;
-  socklen_t socket_error_len = sizeof(socket_error);
-  if (::getsockopt(
-          sock.underlying_handle(), SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_len) == -1) {
-    co_return Failure{SyscallError::current()};
-  }
-  if (socket_error != 0) {
-    co_return Failure{SyscallError{socket_error}};
+  COROSIG_CO_TRYV(pending_connect_result(sock.underlying_handle()));
+  co_return sock;
+}
+
+Fut<TcpSocket, Error<AllocationError, SyscallError>>
+connect_and_send_impl(Reactor &r,
+                      SockaddrStorage const &target,
+                      std::span<char const> payload,
+                      TcpSocket sock) noexcept {
+  size_t sent = 0;
+
+#ifdef MSG_FASTOPEN
+  ssize_t fastopen_sent = ::sendto(sock.underlying_handle(),
+                                   payload.data(),
+                                   payload.size(),
+                                   MSG_FASTOPEN,
+                                   reinterpret_cast<sockaddr const *>(&target.native_storage),
+                                   os::posix::addr_length(target.native_storage));
+  auto current_error = SyscallError::current();
+
+  // EINPROGRESS means that there is no cookie yet, so SYN has been sent without data
+  if (fastopen_sent != -1 || current_error.value == EINPROGRESS) {
+    sent = fastopen_sent == -1 ? 0 : static_cast<size_t>(fastopen_sent);
+
+    int on = 1;
+    // Not a hard failure. Just a little bit of performance loss
+    (void)::setsockopt(sock.underlying_handle(), SOL_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    co_await PollEvent{sock.underlying_handle(),
+                       PollEventExpectance::CAN_WRITE | PollEventExpectance::CAN_READ};
+    COROSIG_CO_TRYV(pending_connect_result(sock.underlying_handle()));
+  } else if (current_error.value == EOPNOTSUPP) {
+    // Fast open is disabled system-wide
+    COROSIG_CO_TRY(sock, co_await connect_impl(r, target, std::move(sock)));
+  } else {
+    co_return Failure{current_error};
   }
+#else
+  COROSIG_CO_TRY(sock, co_await connect_impl(r, target, std::move(sock)));
+#endif
 
+  if (sent < payload.size()) {
+    COROSIG_CO_TRYV(co_await sock.write(r, payload.subspan(sent)));
+  }
   co_return sock;
 }
 
@@ -130,6 +176,18 @@ Fut<TcpSocket, Error<AllocationError, SyscallError>> TcpSocket::connect_from(
   return connect_impl(r, target, TcpSocket::make_from_os_specific_handle(sock));
 }
 
+Fut<TcpSocket, Error<AllocationError, SyscallError>> TcpSocket::connect_and_send(
+    Reactor &r, SockaddrStorage const &target, std::span<char const> payload) noexcept {
+  using Fut = Fut<TcpSocket, Error<AllocationError, SyscallError>>;
+  int sock = ::socket(target.native_storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+  if (sock == -1) {
+    return Fut::make_ready(Failure{SyscallError::current()});
+  }
+
+  return connect_and_send_impl(
+      r, target, payload, TcpSocket::make_from_os_specific_handle(sock));
+}
+
 TcpSocket TcpSocket::make_from_os_specific_handle(os::Handle handle) noexcept {
   TcpSocket sock;
   sock.m_fd = handle;
@@ -0,0 +1,93 @@
+#include "corosig/io/Transfer.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/PollEvent.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+namespace corosig {
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+transfer(Reactor &, File &from, TcpSocket &to, uint64_t offset, size_t len) noexcept {
+#ifdef __linux__
+  auto file_offset = static_cast<off_t>(offset);
+  size_t sent = 0;
+  while (sent < len) {
+    co_await PollEvent{to.underlying_handle(), PollEventExpectance::CAN_WRITE};
+
+    ssize_t n = ::sendfile(to.underlying_handle(), from.underlying_handle(), &file_offset,
+                           len - sent);
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EINTR) {
+        continue;
+      }
+      if (sent == 0) {
+        co_return Failure{SyscallError::current()};
+      }
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  co_return sent;
+#else
+  (void)from;
+  (void)to;
+  (void)offset;
+  (void)len;
+  co_return Failure{SyscallError{ENOSYS}};
+#endif
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+transfer(Reactor &, PipeRead &from, PipeWrite &to, size_t len) noexcept {
+#ifdef __linux__
+  size_t moved = 0;
+  while (moved < len) {
+    co_await PollEvent{from.underlying_handle(), PollEventExpectance::CAN_READ};
+
+    ssize_t n = ::splice(from.underlying_handle(), nullptr, to.underlying_handle(), nullptr,
+                         len - moved, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (n == -1) {
+      if (errno == EAGAIN) {
+        // input is readable, so it's output which is full
+        co_await PollEvent{to.underlying_handle(), PollEventExpectance::CAN_WRITE};
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      if (moved == 0) {
+        co_return Failure{SyscallError::current()};
+      }
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    moved += static_cast<size_t>(n);
+  }
+  co_return moved;
+#else
+  (void)from;
+  (void)to;
+  (void)len;
+  co_return Failure{SyscallError{ENOSYS}};
+#endif
+}
+
+} // namespace corosig
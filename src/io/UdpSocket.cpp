@@ -9,11 +9,33 @@
 #include "corosig/reactor/PollList.hpp"
 #include "posix/FdOps.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
 #include <span>
 #include <sys/socket.h>
 #include <unistd.h>
 
+namespace {
+
+#ifdef UDP_SEGMENT
+
+/// Older kernels refuse to segment a single send into more datagrams than that
+constexpr size_t MAX_SEGMENTS_PER_SEND = 64;
+
+bool means_segmentation_unsupported(int error) noexcept {
+  return error == EIO || error == EINVAL || error == ENOPROTOOPT || error == EOPNOTSUPP;
+}
+
+#endif
+
+} // namespace
+
 namespace corosig {
 
 UdpSocket UdpSocket::make_from_os_specific_handle(os::Handle handle) noexcept {
@@ -88,6 +110,225 @@ Result<size_t, SyscallError> UdpSocket::try_send_to(std::span<char const> messag
   return static_cast<size_t>(result);
 }
 
+Fut<size_t, Error<AllocationError, SyscallError>>
+UdpSocket::send_batch(Reactor &, std::span<OutgoingDatagram const> datagrams) noexcept {
+  size_t sent = 0;
+  while (sent < datagrams.size()) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+    auto res = try_send_batch(datagrams.subspan(sent));
+    if (res) {
+      sent += res.value();
+    } else if (res.error().value != EAGAIN && res.error().value != EINTR) {
+      if (sent != 0) {
+        break;
+      }
+      co_return Failure{res.error()};
+    }
+  }
+  co_return sent;
+}
+
+Result<size_t, SyscallError>
+UdpSocket::try_send_batch(std::span<OutgoingDatagram const> datagrams) noexcept {
+#ifdef __linux__
+  std::array<mmsghdr, MAX_BATCH_SIZE> headers{};
+  std::array<iovec, MAX_BATCH_SIZE> iovecs{};
+  size_t count = std::min(datagrams.size(), MAX_BATCH_SIZE);
+
+  for (size_t i = 0; i < count; ++i) {
+    OutgoingDatagram const &dgram = datagrams[i];
+    iovecs[i].iov_base = const_cast<char *>(dgram.data.data());
+    iovecs[i].iov_len = dgram.data.size();
+
+    msghdr &hdr = headers[i].msg_hdr;
+    hdr.msg_iov = &iovecs[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_name = const_cast<sockaddr_storage *>(&dgram.dest->native_storage);
+    hdr.msg_namelen = os::posix::addr_length(dgram.dest->native_storage);
+  }
+
+  int result = ::sendmmsg(m_fd.value, headers.data(), count, 0);
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(result);
+#else
+  size_t sent = 0;
+  for (OutgoingDatagram const &dgram : datagrams) {
+    auto res = try_send_to(dgram.data, *dgram.dest);
+    if (!res) {
+      if (sent == 0) {
+        return Failure{res.error()};
+      }
+      break;
+    }
+    ++sent;
+  }
+  return sent;
+#endif
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UdpSocket::recv_batch(Reactor &, std::span<IncomingDatagram> slots) noexcept {
+  if (slots.empty()) {
+    co_return size_t{0};
+  }
+  while (true) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+    auto res = try_recv_batch(slots);
+    if (res || (res.error().value != EAGAIN && res.error().value != EINTR)) {
+      co_return std::move(res);
+    }
+  }
+}
+
+Result<size_t, SyscallError> UdpSocket::try_recv_batch(std::span<IncomingDatagram> slots) noexcept {
+#ifdef __linux__
+  size_t received = 0;
+  while (received < slots.size()) {
+    std::span<IncomingDatagram> chunk =
+        slots.subspan(received, std::min(slots.size() - received, MAX_BATCH_SIZE));
+
+    std::array<mmsghdr, MAX_BATCH_SIZE> headers{};
+    std::array<iovec, MAX_BATCH_SIZE> iovecs{};
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      iovecs[i].iov_base = chunk[i].buffer.data();
+      iovecs[i].iov_len = chunk[i].buffer.size();
+
+      msghdr &hdr = headers[i].msg_hdr;
+      hdr.msg_iov = &iovecs[i];
+      hdr.msg_iovlen = 1;
+      if (chunk[i].source != nullptr) {
+        hdr.msg_name = &chunk[i].source->native_storage;
+        hdr.msg_namelen = sizeof(chunk[i].source->native_storage);
+      }
+    }
+
+    // MSG_TRUNC makes kernel report real datagram sizes, so truncation is visible to caller
+    int result = ::recvmmsg(m_fd.value, headers.data(), chunk.size(), MSG_DONTWAIT | MSG_TRUNC,
+                            nullptr);
+    if (result == -1) {
+      if (received != 0) {
+        break;
+      }
+      return Failure{SyscallError::current()};
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(result); ++i) {
+      chunk[i].size = headers[i].msg_len;
+    }
+    received += static_cast<size_t>(result);
+    if (static_cast<size_t>(result) < chunk.size()) {
+      break;
+    }
+  }
+  return received;
+#else
+  size_t received = 0;
+  for (IncomingDatagram &slot : slots) {
+    auto res = try_recv_from(slot.buffer, slot.source);
+    if (!res) {
+      if (received == 0) {
+        return Failure{res.error()};
+      }
+      break;
+    }
+    slot.size = res.value();
+    ++received;
+  }
+  return received;
+#endif
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UdpSocket::send_segmented(Reactor &,
+                          std::span<char const> buffer,
+                          size_t segment_size,
+                          SockaddrStorage const &dest) noexcept {
+  size_t sent = 0;
+  while (sent < buffer.size()) {
+    co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+    auto res = try_send_segmented(buffer.subspan(sent), segment_size, dest);
+    if (res) {
+      sent += res.value();
+    } else if (res.error().value != EAGAIN && res.error().value != EINTR) {
+      if (sent != 0) {
+        break;
+      }
+      co_return Failure{res.error()};
+    }
+  }
+  co_return sent;
+}
+
+Result<size_t, SyscallError> UdpSocket::try_send_segmented(std::span<char const> buffer,
+                                                           size_t segment_size,
+                                                           SockaddrStorage const &dest) noexcept {
+  if (segment_size == 0) {
+    return Failure{SyscallError{EINVAL}};
+  }
+
+#ifdef UDP_SEGMENT
+  size_t segments_per_send = std::min(MAX_SEGMENTS_PER_SEND, MAX_PAYLOAD_SIZE / segment_size);
+  if (!m_segmentation_unsupported && segments_per_send > 1 && buffer.size() > segment_size) {
+    std::span<char const> chunk =
+        buffer.first(std::min(buffer.size(), segments_per_send * segment_size));
+    iovec iov{.iov_base = const_cast<char *>(chunk.data()), .iov_len = chunk.size()};
+
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(uint16_t))> control{};
+    msghdr hdr{};
+    hdr.msg_name = const_cast<sockaddr_storage *>(&dest.native_storage);
+    hdr.msg_namelen = os::posix::addr_length(dest.native_storage);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control.data();
+    hdr.msg_controllen = control.size();
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    auto gso_size = static_cast<uint16_t>(segment_size);
+    std::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+    ssize_t result = ::sendmsg(m_fd.value, &hdr, 0);
+    if (result != -1) {
+      return static_cast<size_t>(result);
+    }
+
+    SyscallError error = SyscallError::current();
+    if (!means_segmentation_unsupported(error.value)) {
+      return Failure{error};
+    }
+    m_segmentation_unsupported = true;
+  }
+#endif
+
+  return try_send_segments_in_batch(buffer, segment_size, dest);
+}
+
+Result<size_t, SyscallError>
+UdpSocket::try_send_segments_in_batch(std::span<char const> buffer,
+                                      size_t segment_size,
+                                      SockaddrStorage const &dest) noexcept {
+  std::array<OutgoingDatagram, MAX_BATCH_SIZE> batch;
+  size_t count = 0;
+  for (size_t offset = 0; offset < buffer.size() && count < batch.size(); offset += segment_size) {
+    batch[count++] = OutgoingDatagram{
+        .data = buffer.subspan(offset, std::min(segment_size, buffer.size() - offset)),
+        .dest = &dest,
+    };
+  }
+
+  COROSIG_TRY(size_t sent, try_send_batch(std::span{batch}.first(count)));
+
+  size_t sent_bytes = 0;
+  for (OutgoingDatagram const &dgram : std::span{batch}.first(sent)) {
+    sent_bytes += dgram.data.size();
+  }
+  return sent_bytes;
+}
+
 Result<SockaddrStorage, SyscallError> UdpSocket::address() const noexcept {
   return os::posix::socket_address(m_fd.value);
 }
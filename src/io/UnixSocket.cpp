@@ -0,0 +1,439 @@
+#include "corosig/io/UnixSocket.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/PollEvent.hpp"
+#include "corosig/Result.hpp"
+#include "corosig/Yield.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/os/Handle.hpp"
+#include "corosig/reactor/PollList.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "posix/FdOps.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <span>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace corosig;
+
+using ControlBuffer = std::array<char, CMSG_SPACE(sizeof(int) * MAX_PASSED_HANDLES)>;
+
+Result<int, SyscallError> make_socket(int type) noexcept {
+  int fd = ::socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return fd;
+}
+
+Result<std::array<int, 2>, SyscallError> make_socket_pair(int type) noexcept {
+  std::array<int, 2> fds;
+  if (::socketpair(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds.data()) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return fds;
+}
+
+Result<void, SyscallError> bind_to(int fd, SockaddrStorage const &local) noexcept {
+  if (::bind(fd,
+             reinterpret_cast<sockaddr const *>(&local.native_storage),
+             os::posix::addr_length(local.native_storage)) != 0) {
+    return Failure{SyscallError::current()};
+  }
+  return Ok{};
+}
+
+Result<size_t, SyscallError> send_with_handles(int fd,
+                                               std::span<char const> data,
+                                               std::span<os::Handle const> handles) noexcept {
+  if (handles.size() > MAX_PASSED_HANDLES) {
+    return Failure{SyscallError{EINVAL}};
+  }
+
+  iovec iov{.iov_base = const_cast<char *>(data.data()), .iov_len = data.size()};
+  msghdr hdr{};
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+
+  alignas(cmsghdr) ControlBuffer control{};
+  if (!handles.empty()) {
+    hdr.msg_control = control.data();
+    hdr.msg_controllen = CMSG_SPACE(handles.size_bytes());
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(handles.size_bytes());
+    std::memcpy(CMSG_DATA(cmsg), handles.data(), handles.size_bytes());
+  }
+
+  ssize_t result = ::sendmsg(fd, &hdr, 0);
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(result);
+}
+
+Result<ReceivedWithHandles, SyscallError>
+recv_with_handles(int fd, std::span<char> data, std::span<os::Handle> handles) noexcept {
+  handles = handles.first(std::min(handles.size(), MAX_PASSED_HANDLES));
+
+  iovec iov{.iov_base = data.data(), .iov_len = data.size()};
+  msghdr hdr{};
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+
+  alignas(cmsghdr) ControlBuffer control{};
+  if (!handles.empty()) {
+    hdr.msg_control = control.data();
+    hdr.msg_controllen = CMSG_SPACE(handles.size_bytes());
+  }
+
+  int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+  ssize_t result = ::recvmsg(fd, &hdr, flags);
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+
+  ReceivedWithHandles received{.size = static_cast<size_t>(result)};
+  for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    count = std::min(count, handles.size() - received.handles);
+    std::memcpy(handles.data() + received.handles, CMSG_DATA(cmsg), count * sizeof(int));
+#ifndef MSG_CMSG_CLOEXEC
+    for (os::Handle handle : handles.subspan(received.handles, count)) {
+      (void)::fcntl(handle, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    received.handles += count;
+  }
+  return received;
+}
+
+} // namespace
+
+namespace corosig {
+
+UnixStream::~UnixStream() {
+  close();
+}
+
+Fut<UnixStream, Error<AllocationError, SyscallError>>
+UnixStream::connect(Reactor &, SockaddrStorage const &target) noexcept {
+  COROSIG_CO_TRY(int fd, make_socket(SOCK_STREAM));
+  UnixStream stream = make_from_os_specific_handle(fd);
+
+  while (::connect(fd,
+                   reinterpret_cast<sockaddr const *>(&target.native_storage),
+                   os::posix::addr_length(target.native_storage)) == -1) {
+    auto current_error = SyscallError::current();
+    if (current_error.value == EAGAIN) {
+      // Listener's backlog is full. Unlike TCP, connection has to be retried
+      co_await Yield{};
+      continue;
+    }
+    if (current_error.value != EINPROGRESS) {
+      co_return Failure{current_error};
+    }
+
+    co_await PollEvent{fd, PollEventExpectance::CAN_WRITE};
+    int socket_error = 0;
+    socklen_t socket_error_len = sizeof(socket_error);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_len) == -1) {
+      co_return Failure{SyscallError::current()};
+    }
+    if (socket_error != 0) {
+      co_return Failure{SyscallError{socket_error}};
+    }
+    break;
+  }
+
+  co_return stream;
+}
+
+Result<std::array<UnixStream, 2>, SyscallError> UnixStream::make_pair() noexcept {
+  COROSIG_TRY(auto fds, make_socket_pair(SOCK_STREAM));
+  return std::array{make_from_os_specific_handle(fds[0]), make_from_os_specific_handle(fds[1])};
+}
+
+UnixStream UnixStream::make_from_os_specific_handle(os::Handle handle) noexcept {
+  UnixStream stream;
+  stream.m_fd = handle;
+  return stream;
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> UnixStream::read(Reactor &r,
+                                                                   std::span<char> buf) noexcept {
+  return os::posix::read(r, m_fd.value, buf);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UnixStream::read_some(Reactor &r, std::span<char> buf) noexcept {
+  return os::posix::read_some(r, m_fd.value, buf);
+}
+
+Result<size_t, SyscallError> UnixStream::try_read_some(std::span<char> buf) noexcept {
+  return os::posix::try_read_some(m_fd.value, buf);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UnixStream::write(Reactor &r, std::span<char const> buf) noexcept {
+  return os::posix::write(r, m_fd.value, buf);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UnixStream::write_some(Reactor &r, std::span<char const> buf) noexcept {
+  return os::posix::write_some(r, m_fd.value, buf);
+}
+
+Result<size_t, SyscallError> UnixStream::try_write_some(std::span<char const> buf) noexcept {
+  return os::posix::try_write_some(m_fd.value, buf);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> UnixStream::send_handles(
+    Reactor &, std::span<char const> buf, std::span<os::Handle const> handles) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+  co_return try_send_handles(buf, handles);
+}
+
+Result<size_t, SyscallError>
+UnixStream::try_send_handles(std::span<char const> buf,
+                             std::span<os::Handle const> handles) noexcept {
+  if (buf.empty()) {
+    return Failure{SyscallError{EINVAL}};
+  }
+  return send_with_handles(m_fd.value, buf, handles);
+}
+
+Fut<ReceivedWithHandles, Error<AllocationError, SyscallError>>
+UnixStream::recv_handles(Reactor &, std::span<char> buf, std::span<os::Handle> handles) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  co_return try_recv_handles(buf, handles);
+}
+
+Result<ReceivedWithHandles, SyscallError>
+UnixStream::try_recv_handles(std::span<char> buf, std::span<os::Handle> handles) noexcept {
+  return recv_with_handles(m_fd.value, buf, handles);
+}
+
+Result<SockaddrStorage, SyscallError> UnixStream::address() const noexcept {
+  return os::posix::socket_address(m_fd.value);
+}
+
+void UnixStream::close() noexcept {
+  return os::posix::close(m_fd.value);
+}
+
+os::Handle UnixStream::underlying_handle() const noexcept {
+  return m_fd.value;
+}
+
+Result<UnixListener, SyscallError> UnixListener::make(Options options) noexcept {
+  COROSIG_TRY(int fd, make_socket(SOCK_STREAM));
+  auto listener = UnixListener::make_from_os_specific_handle(fd);
+
+  COROSIG_TRYV(bind_to(fd, options.addr));
+
+  auto backlog =
+      static_cast<int>(std::min<size_t>(options.backlog_size, std::numeric_limits<int>::max()));
+  if (::listen(fd, backlog) != 0) {
+    return Failure{SyscallError::current()};
+  }
+
+  return listener;
+}
+
+UnixListener UnixListener::make_from_os_specific_handle(os::Handle handle) noexcept {
+  UnixListener listener;
+  listener.m_fd = handle;
+  return listener;
+}
+
+UnixListener::~UnixListener() {
+  close();
+}
+
+Fut<UnixStream, Error<AllocationError, SyscallError>> UnixListener::accept(Reactor &) noexcept {
+  if (auto res = try_accept(); res.is_ok() || (res.error().value != EWOULDBLOCK)) {
+    co_return res;
+  }
+
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  co_return try_accept();
+}
+
+Result<UnixStream, SyscallError> UnixListener::try_accept() noexcept {
+#ifdef __linux__
+  int fd = ::accept4(m_fd.value, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return UnixStream::make_from_os_specific_handle(fd);
+#else
+  int fd = ::accept(m_fd.value, nullptr, nullptr);
+  if (fd == -1) {
+    return Failure{SyscallError::current()};
+  }
+  auto stream = UnixStream::make_from_os_specific_handle(fd);
+
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1 ||
+      fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return stream;
+#endif
+}
+
+Result<SockaddrStorage, SyscallError> UnixListener::address() const noexcept {
+  return os::posix::socket_address(m_fd.value);
+}
+
+void UnixListener::close() noexcept {
+  return os::posix::close(m_fd.value);
+}
+
+os::Handle UnixListener::underlying_handle() const noexcept {
+  return m_fd.value;
+}
+
+Result<UnixDatagram, SyscallError> UnixDatagram::unbound() noexcept {
+  COROSIG_TRY(int fd, make_socket(SOCK_DGRAM));
+  return make_from_os_specific_handle(fd);
+}
+
+Result<UnixDatagram, SyscallError> UnixDatagram::bound(SockaddrStorage const &local) noexcept {
+  COROSIG_TRY(auto self, unbound());
+  COROSIG_TRYV(bind_to(self.m_fd.value, local));
+  return self;
+}
+
+Result<std::array<UnixDatagram, 2>, SyscallError> UnixDatagram::make_pair() noexcept {
+  COROSIG_TRY(auto fds, make_socket_pair(SOCK_DGRAM));
+  return std::array{make_from_os_specific_handle(fds[0]), make_from_os_specific_handle(fds[1])};
+}
+
+UnixDatagram UnixDatagram::make_from_os_specific_handle(os::Handle handle) noexcept {
+  UnixDatagram sock;
+  sock.m_fd = handle;
+  return sock;
+}
+
+UnixDatagram::~UnixDatagram() {
+  close();
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UnixDatagram::recv_from(Reactor &, std::span<char> out, SockaddrStorage *source_addr) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  co_return try_recv_from(out, source_addr);
+}
+
+Result<size_t, SyscallError> UnixDatagram::try_recv_from(std::span<char> out,
+                                                         SockaddrStorage *source_addr) noexcept {
+  socklen_t addrlen = sizeof(SockaddrStorage::native_storage);
+  socklen_t *addrlen_ptr = nullptr;
+  sockaddr *addr_ptr = nullptr;
+
+  if (source_addr != nullptr) {
+    *source_addr = SockaddrStorage{};
+    addrlen_ptr = &addrlen;
+    addr_ptr = reinterpret_cast<sockaddr *>(&source_addr->native_storage);
+  }
+
+  ssize_t result =
+      ::recvfrom(m_fd.value, out.data(), out.size(), MSG_TRUNC, addr_ptr, addrlen_ptr);
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(result);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> UnixDatagram::send_to(
+    Reactor &, std::span<char const> message, SockaddrStorage const &dest) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+  co_return try_send_to(message, dest);
+}
+
+Result<size_t, SyscallError> UnixDatagram::try_send_to(std::span<char const> message,
+                                                       SockaddrStorage const &dest) noexcept {
+  ssize_t result = ::sendto(m_fd.value,
+                            message.data(),
+                            message.size(),
+                            0,
+                            reinterpret_cast<sockaddr const *>(&dest.native_storage),
+                            os::posix::addr_length(dest.native_storage));
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(result);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>>
+UnixDatagram::send(Reactor &, std::span<char const> message) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+  co_return try_send(message);
+}
+
+Result<size_t, SyscallError> UnixDatagram::try_send(std::span<char const> message) noexcept {
+  ssize_t result = ::send(m_fd.value, message.data(), message.size(), 0);
+  if (result == -1) {
+    return Failure{SyscallError::current()};
+  }
+  return static_cast<size_t>(result);
+}
+
+Fut<size_t, Error<AllocationError, SyscallError>> UnixDatagram::send_handles(
+    Reactor &, std::span<char const> message, std::span<os::Handle const> handles) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_WRITE};
+  co_return try_send_handles(message, handles);
+}
+
+Result<size_t, SyscallError>
+UnixDatagram::try_send_handles(std::span<char const> message,
+                               std::span<os::Handle const> handles) noexcept {
+  return send_with_handles(m_fd.value, message, handles);
+}
+
+Fut<ReceivedWithHandles, Error<AllocationError, SyscallError>> UnixDatagram::recv_handles(
+    Reactor &, std::span<char> out, std::span<os::Handle> handles) noexcept {
+  co_await PollEvent{m_fd.value, PollEventExpectance::CAN_READ};
+  co_return try_recv_handles(out, handles);
+}
+
+Result<ReceivedWithHandles, SyscallError>
+UnixDatagram::try_recv_handles(std::span<char> out, std::span<os::Handle> handles) noexcept {
+  return recv_with_handles(m_fd.value, out, handles);
+}
+
+Result<SockaddrStorage, SyscallError> UnixDatagram::address() const noexcept {
+  return os::posix::socket_address(m_fd.value);
+}
+
+void UnixDatagram::close() noexcept {
+  return os::posix::close(m_fd.value);
+}
+
+os::Handle UnixDatagram::underlying_handle() const noexcept {
+  return m_fd.value;
+}
+
+} // namespace corosig
@@ -2,15 +2,19 @@
 
 #include "corosig/Clock.hpp"
 #include "corosig/ErrorTypes.hpp"
+#include "corosig/PollEvent.hpp"
 #include "corosig/Result.hpp"
 #include "corosig/Sleep.hpp"
 #include "corosig/io/Sockaddr.hpp"
 #include "corosig/io/dns/Protocol.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cerrno>
 #include <concepts>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <string_view>
 
 namespace {
@@ -207,33 +211,48 @@ Fut<void, Error<AllocationError, SyscallError>> CachelessResolver::periodic_back
 }
 
 CachelessResolver::receiver_type CachelessResolver::receive_server_answers(Reactor &r) noexcept {
+  std::array<char, 512> response_buf;
+
   while (!m_pending_requests.empty()) {
-    std::array<char, 512> response_buf;
+    co_await PollEvent{m_udp_socket.underlying_handle(), PollEventExpectance::CAN_READ};
+
+    // Answers to concurrently sent questions tend to arrive together, so all of them are taken
+    // before polling again
+    while (!m_pending_requests.empty()) {
+      Result received = m_udp_socket.try_recv_from(response_buf);
+      if (!received) {
+        if (received.error().value == EINTR) {
+          continue;
+        }
+        if (received.error().value == EAGAIN) {
+          break;
+        }
+        co_return Failure{received.error()};
+      }
 
-    COROSIG_CO_TRY(size_t response_size, co_await m_udp_socket.recv_from(r, response_buf, nullptr));
+      size_t response_size = std::min(received.value(), response_buf.size());
 
-    response_size = std::min(response_size, response_buf.size());
+      ResponseDecoder decoder{std::span{
+          reinterpret_cast<uint8_t const *>(response_buf.data()),
+          response_size / sizeof(uint8_t),
+      }};
 
-    ResponseDecoder decoder{std::span{
-        reinterpret_cast<uint8_t const *>(response_buf.data()),
-        response_size / sizeof(uint8_t),
-    }};
+      Result header_result = decoder.consume_header();
+      if (!header_result) {
+        continue;
+      }
+      Header header = header_result.value();
 
-    Result header_result = decoder.consume_header();
-    if (!header_result) {
-      continue;
-    }
-    Header header = header_result.value();
+      auto current_request = m_pending_requests.find(header.id, std::less<>{});
 
-    auto current_request = m_pending_requests.find(header.id, std::less<>{});
+      if (current_request == m_pending_requests.end()) {
+        continue;
+      }
 
-    if (current_request == m_pending_requests.end()) {
-      continue;
+      current_request->process_server_answer(header, decoder);
+      current_request->hook.unlink();
+      r.schedule(*current_request);
     }
-
-    current_request->process_server_answer(header, decoder);
-    current_request->hook.unlink();
-    r.schedule(*current_request);
   }
 
   co_return Ok{};
@@ -7,12 +7,16 @@
 #include "corosig/reactor/PollList.hpp"
 #include "corosig/reactor/Reactor.hpp"
 
+#include <array>
 #include <cassert>
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <netinet/in.h>
 #include <span>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
@@ -63,11 +67,11 @@ write(Reactor &, int fd, std::span<char const> buf) noexcept {
   while (written < buf.size()) {
     co_await PollEvent{fd, PollEventExpectance::CAN_WRITE};
 
-    Result current_write = try_write_some(fd, buf);
+    Result current_write = try_write_some(fd, buf.subspan(written));
     if (current_write.is_ok()) {
       written += current_write.value();
     } else if (written == 0) {
-      co_return Failure{SyscallError::current()};
+      co_return Failure{current_write.error()};
     } else {
       break;
     }
@@ -90,6 +94,30 @@ Result<size_t, SyscallError> try_write_some(int fd, std::span<char const> buf) n
   return static_cast<size_t>(n);
 }
 
+Fut<void, Error<AllocationError, SyscallError>> write_vectored(
+    Reactor &, int fd, std::span<std::span<char const> const> bufs, size_t &written) noexcept {
+  size_t total = total_size(bufs);
+  size_t done = 0;
+  while (done < total) {
+    co_await PollEvent{fd, PollEventExpectance::CAN_WRITE};
+
+    // skip what was written by previous iterations and gather the rest
+    std::array<iovec, MAX_VECTORED_BUFFERS> iov;
+    size_t iov_count = gather(bufs, done, iov);
+    ssize_t n = ::writev(fd, iov.data(), static_cast<int>(iov_count));
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EINTR) {
+        continue;
+      }
+      co_return Failure{SyscallError::current()};
+    }
+    done += static_cast<size_t>(n);
+    written += static_cast<size_t>(n);
+  }
+
+  co_return Ok{};
+}
+
 void close(int &fd) noexcept {
   if (fd != -1) {
     ::close(fd);
@@ -103,8 +131,19 @@ socklen_t addr_length(sockaddr_storage const &storage) noexcept {
     return sizeof(sockaddr_in);
   case AF_INET6:
     return sizeof(sockaddr_in6);
-  case AF_UNIX:
-    return sizeof(sockaddr_un);
+  case AF_UNIX: {
+    auto const &un = reinterpret_cast<sockaddr_un const &>(storage);
+    if (un.sun_path[0] != '\0') {
+      return sizeof(sockaddr_un);
+    }
+    // Trailing zeros are a part of abstract name, so length has to be exact
+    size_t name_size = ::strnlen(un.sun_path + 1, sizeof(un.sun_path) - 1);
+    if (name_size == 0) {
+      // Unnamed address. Binding to it makes kernel choose a unique abstract name
+      return sizeof(sa_family_t);
+    }
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name_size);
+  }
   default:
     assert(false && "Unsupported address family");
     return std::numeric_limits<socklen_t>::max();
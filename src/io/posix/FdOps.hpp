@@ -6,10 +6,12 @@
 #include "corosig/Result.hpp"
 #include "corosig/io/Sockaddr.hpp"
 
+#include <array>
 #include <cstddef>
 #include <netinet/in.h>
 #include <span>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
@@ -25,6 +27,51 @@ Fut<size_t, Error<AllocationError, SyscallError>>
 write_some(Reactor &, int fd, std::span<char const>) noexcept;
 Result<size_t, SyscallError> try_write_some(int fd, std::span<char const>) noexcept;
 
+/// Maximum amount of buffers passed to a single vectored syscall
+constexpr size_t MAX_VECTORED_BUFFERS = 16;
+
+/// Fill iov with buffers, skipping first skip bytes of them. Buffers past iov capacity are left
+/// for the next call
+/// @returns Amount of filled iovecs
+template <typename CHAR>
+size_t gather(std::span<std::span<CHAR> const> bufs,
+              size_t skip,
+              std::array<iovec, MAX_VECTORED_BUFFERS> &iov) noexcept {
+  size_t iov_count = 0;
+  for (std::span<CHAR> buf : bufs) {
+    if (iov_count == iov.size()) {
+      break;
+    }
+    if (skip >= buf.size()) {
+      skip -= buf.size();
+      continue;
+    }
+    buf = buf.subspan(skip);
+    skip = 0;
+    iov[iov_count++] = iovec{const_cast<char *>(buf.data()), buf.size()};
+  }
+  return iov_count;
+}
+
+/// Sum of sizes of all buffers
+template <typename CHAR>
+size_t total_size(std::span<std::span<CHAR> const> bufs) noexcept {
+  size_t total = 0;
+  for (std::span<CHAR> buf : bufs) {
+    total += buf.size();
+  }
+  return total;
+}
+
+/// Write all bytes of all buffers in order, gathering them with writev. Amount written by each
+/// syscall is added to written right after it, so it stays exact if an error is returned or the
+/// future is dropped midway
+Fut<void, Error<AllocationError, SyscallError>>
+write_vectored(Reactor &,
+               int fd,
+               std::span<std::span<char const> const>,
+               size_t &written) noexcept;
+
 Fut<size_t, Error<AllocationError, SyscallError>> read(Reactor &, int fd, std::span<char>) noexcept;
 Fut<size_t, Error<AllocationError, SyscallError>>
 read_some(Reactor &, int fd, std::span<char>) noexcept;
@@ -0,0 +1,67 @@
+#include "corosig/CrashHelper.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <sys/wait.h>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+CrashHelper g_helper;
+std::string g_path;
+
+Fut<void, Error<AllocationError, SyscallError>> ship(Reactor &r,
+                                                     std::span<char const> staged) noexcept {
+  COROSIG_CO_TRY(File file, co_await File::open(r, g_path.c_str(),
+                                                File::OpenFlags::WRONLY | File::OpenFlags::CREATE |
+                                                    File::OpenFlags::TRUNCATE));
+  COROSIG_CO_TRYV(co_await file.write(r, staged));
+  co_return Ok{};
+}
+
+} // namespace
+
+TEST_CASE("CrashHelper ships staged bytes from helper process after hand off") {
+  g_path = tmp_file().native();
+  std::filesystem::remove(g_path);
+  REQUIRE(g_helper.start({.staging_size = 16, .handler = ship}));
+  REQUIRE(g_helper.pid() > 0);
+
+  run_in_sighandler([](Reactor &) {
+    COROSIG_REQUIRE(g_helper.stage("fatal ") == 6);
+    COROSIG_REQUIRE(g_helper.stage("signal, too long to fit") == 10);
+    COROSIG_REQUIRE(g_helper.stage("dropped") == 0);
+    COROSIG_REQUIRE(g_helper.hand_off());
+    COROSIG_REQUIRE(g_helper.hand_off());
+  });
+
+  auto status = g_helper.stop();
+  REQUIRE(status);
+  REQUIRE(WIFEXITED(status.value()));
+  REQUIRE(WEXITSTATUS(status.value()) == 0);
+  REQUIRE(g_helper.pid() == -1);
+  REQUIRE(read_file(g_path) == "fatal signal, to");
+}
+
+TEST_CASE("CrashHelper exits without running handler if nothing was handed off") {
+  g_path = tmp_file().native();
+  std::filesystem::remove(g_path);
+  REQUIRE(g_helper.start({.handler = ship}));
+  REQUIRE(g_helper.stage("never shipped") == 13);
+
+  auto status = g_helper.stop();
+  REQUIRE(status);
+  REQUIRE(WIFEXITED(status.value()));
+  REQUIRE(WEXITSTATUS(status.value()) == 0);
+  REQUIRE(!std::filesystem::exists(g_path));
+}
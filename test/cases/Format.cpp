@@ -0,0 +1,199 @@
+#include "corosig/Format.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/io/BufWriter.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+using namespace corosig;
+
+namespace {
+
+template <typename... ARGS>
+std::string_view fmt(std::span<char> buf,
+                     FormatString<std::type_identity_t<ARGS>...> format,
+                     ARGS const &...args) noexcept {
+  FormatToResult res = format_to(buf, format, args...);
+  return {res.written.data(), res.written.size()};
+}
+
+size_t g_dump_formats = 0;
+
+/// HexDump which counts how many times it is formatted
+struct CountedDump {
+  HexDump dump;
+};
+
+void format_value(detail::FormatOutput &out,
+                  FormatSpec const &spec,
+                  CountedDump const &value) noexcept {
+  ++g_dump_formats;
+  format_value(out, spec, value.dump);
+}
+
+} // namespace
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to formats integers", "[Format]") {
+  std::array<char, 128> buf;
+  COROSIG_REQUIRE(fmt(buf, "{}", 0) == "0");
+  COROSIG_REQUIRE(fmt(buf, "{}", 7) == "7");
+  COROSIG_REQUIRE(fmt(buf, "{}", -42) == "-42");
+  COROSIG_REQUIRE(fmt(buf, "{}", 12345678) == "12345678");
+  COROSIG_REQUIRE(fmt(buf, "{}", 100000000) == "100000000");
+  COROSIG_REQUIRE(fmt(buf, "{}", std::numeric_limits<uint64_t>::max()) ==
+                  "18446744073709551615");
+  COROSIG_REQUIRE(fmt(buf, "{}", std::numeric_limits<int64_t>::min()) ==
+                  "-9223372036854775808");
+  COROSIG_REQUIRE(fmt(buf, "{}", uint8_t{200}) == "200");
+  COROSIG_REQUIRE(fmt(buf, "{:x} {:#X} {:#b} {:#o}", 255, 255, 5, 8) == "ff 0XFF 0b101 010");
+  COROSIG_REQUIRE(fmt(buf, "[{:5}] [{:<5}] [{:05}] [{:#06x}]", 42, 42, -42, 255) ==
+                  "[   42] [42   ] [-0042] [0x00ff]");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to matches naive decimal conversion", "[Format]") {
+  std::array<char, 32> buf;
+  std::array<char, 32> expected_buf;
+  constexpr uint64_t LIMIT = std::numeric_limits<uint64_t>::max() / 3;
+  for (uint64_t value = 1; value < LIMIT; value = (value * 3) + 1) {
+    size_t begin = expected_buf.size();
+    for (uint64_t v = value; v != 0; v /= 10) {
+      expected_buf[--begin] = static_cast<char>('0' + (v % 10));
+    }
+    std::string_view expected{expected_buf.begin() + begin, expected_buf.end()};
+    COROSIG_REQUIRE(fmt(buf, "{}", value) == expected);
+  }
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to formats text, pointers and escapes", "[Format]") {
+  std::array<char, 128> buf;
+  char const *null_str = nullptr;
+  COROSIG_REQUIRE(fmt(buf, "{} {} {} {}", "str", std::string_view{"view"}, 'c', true) ==
+                  "str view c true");
+  COROSIG_REQUIRE(fmt(buf, "{}", null_str) == "(null)");
+  COROSIG_REQUIRE(fmt(buf, "[{:6}] [{:>6}]", "ab", "ab") == "[ab    ] [    ab]");
+  COROSIG_REQUIRE(fmt(buf, "{}", reinterpret_cast<void *>(0x1000)) == "0x1000");
+  COROSIG_REQUIRE(fmt(buf, "{}", nullptr) == "0x0");
+  COROSIG_REQUIRE(fmt(buf, "{{{}}}", 1) == "{1}");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to formats hex dumps and errors", "[Format]") {
+  std::array<char, 128> buf;
+  std::array<uint8_t, 4> bytes = {0xde, 0xad, 0x0b, 0xef};
+  COROSIG_REQUIRE(fmt(buf, "{}", hex_dump(std::span<uint8_t const>{bytes})) == "de ad 0b ef");
+  COROSIG_REQUIRE(fmt(buf, "{:X}", hex_dump("AZ")) == "41 5A");
+  COROSIG_REQUIRE(fmt(buf, "{}", hex_dump("")) == "");
+  COROSIG_REQUIRE(fmt(buf, "{}", SyscallError{ENOENT}) == "No such file or directory (errno 2)");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to formats addresses", "[Format]") {
+  std::array<char, 128> buf;
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv4Addr::from_groups({192, 168, 0, 1})) == "192.168.0.1");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv6Addr::loopback()) == "::1");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv6Addr::from_groups({0x2001, 0xdb8, 0, 0, 1, 0, 0, 1})) ==
+                  "2001:db8::1:0:0:1");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv6Addr::from_groups({0x2001, 0xdb8, 0, 1, 1, 1, 1, 1})) ==
+                  "2001:db8:0:1:1:1:1:1");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv6Addr::from_groups({0, 0, 0, 0, 0, 0xffff, 0x0102, 0x0304})) ==
+                  "::ffff:1.2.3.4");
+  COROSIG_REQUIRE(fmt(buf, "{}", IpvNAddr{Ipv4Addr::loopback()}) == "127.0.0.1");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv4Addr::loopback().to_sockaddr(8080)) == "127.0.0.1:8080");
+  COROSIG_REQUIRE(fmt(buf, "{}", Ipv6Addr::loopback().to_sockaddr(53)) == "[::1]:53");
+  COROSIG_REQUIRE(fmt(buf, "[{:>12}]", Ipv4Addr::loopback()) == "[   127.0.0.1]");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("format_to truncates and reports full size", "[Format]") {
+  std::array<char, 4> buf;
+  FormatToResult res = format_to(buf, "{}-{}", 123, 456);
+  COROSIG_REQUIRE(res.truncated());
+  COROSIG_REQUIRE(res.size == 7);
+  COROSIG_REQUIRE(std::string_view{res.written.data(), res.written.size()} == "123-");
+  COROSIG_REQUIRE(formatted_size("{}-{}", 123, 456) == 7);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("print formats into BufWriter", "[Format]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 64};
+
+    COROSIG_CO_TRYV(co_await print(r, out, "signal {} from {}\n", 11, Ipv4Addr::loopback()));
+    COROSIG_CO_TRYV(co_await out.flush(r));
+
+    std::array<char, 64> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "signal 11 from 127.0.0.1\n");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("print flushes BufWriter once it is full", "[Format]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 64};
+
+    static std::string const part(100, 'x');
+    COROSIG_CO_TRYV(co_await print(r, out, "{}|{}|{}", part, part, part));
+    COROSIG_REQUIRE(out.buffered().size() <= out.capacity());
+    COROSIG_CO_TRYV(co_await out.flush(r));
+
+    std::array<char, 512> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == part + '|' + part + '|' + part);
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("print reports allocation failure right away", "[Format]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    Allocator::Memory<64> mem;
+    Allocator alloc{mem};
+    BufWriter out{std::move(pipes.write), alloc, 1024};
+
+    auto res = co_await print(r, out, "signal {}\n", 11);
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<AllocationError>());
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("print formats text longer than BufWriter once", "[Format]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    static Allocator::Memory<65536> mem;
+    Allocator alloc{mem};
+    BufWriter out{std::move(pipes.write), alloc, 64};
+
+    static std::array<char, 4096> const bytes{};
+    g_dump_formats = 0;
+    CountedDump dump{hex_dump(std::string_view{bytes.data(), bytes.size()})};
+    COROSIG_CO_TRYV(co_await print(r, out, "{}", dump));
+    COROSIG_REQUIRE(g_dump_formats == 1);
+    COROSIG_REQUIRE(out.buffered().empty());
+
+    static std::array<char, 3 * bytes.size()> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(read == 3 * bytes.size() - 1);
+    COROSIG_REQUIRE(std::string_view(buf.data(), 6) == "00 00 ");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
@@ -0,0 +1,99 @@
+#include "corosig/MemoryProfiler.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/Yield.hpp"
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <string_view>
+
+using namespace corosig;
+
+COROSIG_SIGHANDLER_TEST_CASE("Profiler counts allocations and builds size histogram") {
+  Allocator::Memory<1024> mem;
+  Allocator alloc{mem};
+  MemoryProfiler profiler{alloc};
+
+  void *p1 = alloc.allocate(1, 1);
+  void *p2 = alloc.allocate(100, 1);
+  void *p3 = alloc.allocate(100, 1);
+  COROSIG_REQUIRE(p1 && p2 && p3);
+  alloc.deallocate(p2);
+  COROSIG_REQUIRE(alloc.allocate(4096, 1) == nullptr);
+  alloc.deallocate(p1);
+  alloc.deallocate(p3);
+
+  COROSIG_REQUIRE(profiler.allocations() == 3);
+  COROSIG_REQUIRE(profiler.failed_allocations() == 1);
+  COROSIG_REQUIRE(profiler.peak_live_allocations() == 3);
+  COROSIG_REQUIRE(profiler.peak_memory() == alloc.peak_memory());
+
+  auto histogram = profiler.size_histogram();
+  COROSIG_REQUIRE(histogram[1] == 1); // [1, 2)
+  COROSIG_REQUIRE(histogram[7] == 2); // [64, 128)
+  COROSIG_REQUIRE(std::accumulate(histogram.begin(), histogram.end(), size_t{0}) == 3);
+
+  auto sites = profiler.call_sites();
+  size_t from_sites = 0;
+  for (auto const &site : sites) {
+    COROSIG_REQUIRE(site.address != nullptr);
+    COROSIG_REQUIRE(site.max_bytes <= 100);
+    from_sites += site.total_bytes;
+  }
+  COROSIG_REQUIRE(from_sites == 201);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Profiler detaches from allocator on destruction") {
+  Allocator::Memory<1024> mem;
+  Allocator alloc{mem};
+  {
+    MemoryProfiler profiler{alloc};
+  }
+  void *p = alloc.allocate(16, 1);
+  COROSIG_REQUIRE(p != nullptr);
+  alloc.deallocate(p);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Recommended budget covers peak with headroom") {
+  Allocator::Memory<4096> mem;
+  Allocator alloc{mem};
+  MemoryProfiler profiler{alloc};
+
+  void *p = alloc.allocate(2000, 1);
+  COROSIG_REQUIRE(p != nullptr);
+  alloc.deallocate(p);
+
+  COROSIG_REQUIRE(profiler.recommended_budget(0) >= profiler.peak_memory());
+  COROSIG_REQUIRE(profiler.recommended_budget(0) % 1024 == 0);
+  COROSIG_REQUIRE(profiler.recommended_budget(100) >= profiler.peak_memory() * 2);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Profiler observes coroutine frames allocated by reactor") {
+  MemoryProfiler profiler{reactor.allocator()};
+
+  auto foo = [](Reactor &) -> Fut<int> {
+    co_await Yield{};
+    co_return 1;
+  };
+
+  auto res = foo(reactor).block_on();
+  COROSIG_REQUIRE(res);
+  COROSIG_REQUIRE(profiler.allocations() >= 1);
+  COROSIG_REQUIRE(profiler.call_sites().size() >= 1);
+
+  std::array<char, 2048> buf;
+  std::string_view report = profiler.format_report(buf, 8 * 1024);
+  COROSIG_REQUIRE(report.starts_with("corosig memory profile"));
+  COROSIG_REQUIRE(report.find("recommended budget") != std::string_view::npos);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Report is truncated to buffer size") {
+  MemoryProfiler profiler{reactor.allocator()};
+  std::array<char, 10> buf;
+  std::string_view report = profiler.format_report(buf);
+  COROSIG_REQUIRE(report.size() == buf.size());
+}
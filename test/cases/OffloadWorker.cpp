@@ -0,0 +1,115 @@
+#include "corosig/OffloadWorker.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+OffloadWorker g_worker;
+std::string g_path;
+
+} // namespace
+
+TEST_CASE("OffloadWorker opens, syncs and stats files on its own thread") {
+  g_path = tmp_file().native();
+  REQUIRE(g_worker.start());
+  REQUIRE(g_worker.running());
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(File file, co_await g_worker.open(r, g_path.c_str(),
+                                                       File::OpenFlags::WRONLY |
+                                                           File::OpenFlags::CREATE |
+                                                           File::OpenFlags::TRUNCATE));
+      COROSIG_CO_TRYV(co_await file.write(r, "offloaded"));
+
+      // Both calls are in flight at once and complete in any order
+      struct stat st {};
+      auto synced = g_worker.fsync(r, file);
+      auto statted = g_worker.stat(r, g_path.c_str(), st);
+      COROSIG_CO_TRYV(co_await std::move(synced));
+      COROSIG_CO_TRYV(co_await std::move(statted));
+      COROSIG_REQUIRE(st.st_size == 9);
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  g_worker.stop();
+  REQUIRE(!g_worker.running());
+  REQUIRE(std::filesystem::file_size(g_path) == 9);
+}
+
+TEST_CASE("OffloadWorker passes errno of failed calls") {
+  REQUIRE(g_worker.start());
+
+  run_in_sighandler([](Reactor &reactor) {
+    struct stat st {};
+    auto res = g_worker.stat(reactor, "/nonexistent/offload/path", st).block_on();
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<SyscallError>());
+    COROSIG_REQUIRE(res.error().as<SyscallError>().value == ENOENT);
+  });
+
+  g_worker.stop();
+}
+
+TEST_CASE("OffloadWorker frees slots of dropped calls") {
+  REQUIRE(g_worker.start());
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      // Submitting frame is gone long before the call writes into its arguments
+      for (size_t i = 0; i < OffloadWorker::MAX_PENDING; ++i) {
+        int out = 0;
+        (void)g_worker.run(
+            r,
+            [](void *raw) noexcept -> long {
+              ::usleep(10000);
+              *static_cast<int *>(raw) = 1;
+              return 0;
+            },
+            out);
+        COROSIG_REQUIRE(out == 0);
+      }
+
+      for (size_t i = 0; i < 2 * OffloadWorker::MAX_PENDING; ++i) {
+        int value = 0;
+        COROSIG_CO_TRY(long res, co_await g_worker.run(
+                                     r,
+                                     [](void *raw) noexcept -> long {
+                                       return ++*static_cast<int *>(raw);
+                                     },
+                                     value));
+        COROSIG_REQUIRE(res == 1);
+        COROSIG_REQUIRE(value == 1);
+      }
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  g_worker.stop();
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("OffloadWorker makes calls inline when not started") {
+  OffloadWorker worker;
+  COROSIG_REQUIRE(!worker.running());
+
+  auto res = worker.run(reactor, [](void *) noexcept -> long { return 42; }).block_on();
+  COROSIG_REQUIRE(res);
+  COROSIG_REQUIRE(res.value() == 42);
+}
@@ -482,6 +482,28 @@ COROSIG_SIGHANDLER_TEST_CASE("with_deadline: very long deadline allows completio
   COROSIG_REQUIRE(result.value().value() == 700);
 }
 
+COROSIG_SIGHANDLER_TEST_CASE("with_deadline: children are done once waiter is resumed") {
+  // Waiter drops both children as soon as one of them resumes it, and the next iteration reuses
+  // memory of their frames. A child which went on running after resuming waiter would break it
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, TimedOutError>> {
+    auto sleeping_coro = [](Reactor &, std::chrono::milliseconds duration) -> Fut<int> {
+      co_await Sleep{duration};
+      co_return 800;
+    };
+    for (size_t i = 0; i < 20; ++i) {
+      auto timed_out = co_await with_deadline(r, sleeping_coro(r, 50ms), 0ms);
+      COROSIG_REQUIRE(!timed_out.is_ok());
+      COROSIG_REQUIRE(timed_out.error().holds<TimedOutError>());
+
+      COROSIG_CO_TRY(auto completed, co_await with_deadline(r, sleeping_coro(r, 0ms), 1h));
+      COROSIG_REQUIRE(completed.is_ok());
+      COROSIG_REQUIRE(completed.value() == 800);
+    }
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
 namespace {
 
 using namespace corosig;
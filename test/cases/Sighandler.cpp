@@ -0,0 +1,68 @@
+#include "corosig/Sighandler.hpp"
+
+#include "corosig/Coro.hpp"
+#include "corosig/reactor/Reactor.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <csignal>
+#include <cstddef>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace corosig;
+
+namespace {
+
+int g_signal = 0;
+bool g_on_alt_stack = false;
+size_t g_calls = 0;
+
+Fut<void> record(Reactor &, int sig) noexcept {
+  stack_t stack{};
+  ::sigaltstack(nullptr, &stack);
+  g_signal = sig;
+  g_on_alt_stack = (stack.ss_flags & SS_ONSTACK) != 0;
+  ++g_calls;
+  co_return Ok{};
+}
+
+} // namespace
+
+TEST_CASE("install_sighandler runs handler on alternate stack once per install") {
+  REQUIRE(install_sighandler<1024, record>(SIGUSR1));
+  REQUIRE(::raise(SIGUSR1) == 0);
+  REQUIRE(g_calls == 1);
+  REQUIRE(g_signal == SIGUSR1);
+  REQUIRE(g_on_alt_stack);
+
+  struct sigaction current {};
+  REQUIRE(::sigaction(SIGUSR1, nullptr, &current) == 0);
+  REQUIRE(current.sa_handler == SIG_DFL);
+
+  // Reactor prepared by the first install is reused
+  REQUIRE(install_sighandler<1024, record>(SIGUSR1));
+  REQUIRE(::raise(SIGUSR1) == 0);
+  REQUIRE(g_calls == 2);
+}
+
+TEST_CASE("install_alt_stack makes the whole stack resident") {
+  // Catch2 sets its own alternate stack for the main thread, while a new thread has none
+  bool installed = false;
+  bool resident = false;
+  std::thread{[&] {
+    installed = install_alt_stack().is_ok();
+    stack_t stack{};
+    if (::sigaltstack(nullptr, &stack) == -1) {
+      return;
+    }
+    auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> pages(stack.ss_size / page);
+    resident = ::mincore(stack.ss_sp, stack.ss_size, pages.data()) == 0 &&
+               std::ranges::all_of(pages, [](unsigned char p) { return (p & 1) != 0; });
+  }}.join();
+  REQUIRE(installed);
+  REQUIRE(resident);
+}
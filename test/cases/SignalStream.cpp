@@ -0,0 +1,65 @@
+#include "corosig/SignalStream.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+
+using namespace corosig;
+
+namespace {
+
+SignalStream g_stream;
+
+} // namespace
+
+TEST_CASE("SignalStream reads pending signals in a batch") {
+  auto stream = SignalStream::make(std::array{SIGUSR1, SIGUSR2});
+  REQUIRE(stream);
+  g_stream = std::move(stream.value());
+
+  run_in_sighandler([](Reactor &reactor) {
+    std::array<SignalStream::Info, 4> infos;
+    auto empty = g_stream.try_read(infos);
+    COROSIG_REQUIRE(!empty);
+    COROSIG_REQUIRE(empty.error().value == EAGAIN);
+
+    COROSIG_REQUIRE(::kill(::getpid(), SIGUSR1) == 0);
+    COROSIG_REQUIRE(::kill(::getpid(), SIGUSR2) == 0);
+
+    auto read = g_stream.read(reactor, infos).block_on();
+    COROSIG_REQUIRE(read);
+    COROSIG_REQUIRE(read.value() == 2);
+    COROSIG_REQUIRE(infos[0].ssi_signo == SIGUSR1);
+    COROSIG_REQUIRE(infos[1].ssi_signo == SIGUSR2);
+    COROSIG_REQUIRE(infos[0].ssi_pid == static_cast<uint32_t>(::getpid()));
+  });
+
+  g_stream.close();
+}
+
+TEST_CASE("SignalStream read waits for a signal to arrive") {
+  auto stream = SignalStream::make(std::array{SIGUSR1});
+  REQUIRE(stream);
+  g_stream = std::move(stream.value());
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      std::array<SignalStream::Info, 4> infos;
+      auto waiting = g_stream.read(r, infos);
+      COROSIG_REQUIRE(::kill(::getpid(), SIGUSR1) == 0);
+      COROSIG_CO_TRY(size_t read, co_await std::move(waiting));
+      COROSIG_REQUIRE(read == 1);
+      COROSIG_REQUIRE(infos[0].ssi_signo == SIGUSR1);
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  g_stream.close();
+}
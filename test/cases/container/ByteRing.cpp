@@ -0,0 +1,135 @@
+#include "corosig/container/ByteRing.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+using namespace corosig;
+
+namespace {
+
+void produce(ByteRing &ring, std::string_view data) noexcept {
+  std::span<char> free = ring.writable();
+  std::ranges::copy(data, free.begin());
+  ring.commit(data.size());
+}
+
+} // namespace
+
+COROSIG_SIGHANDLER_TEST_CASE("ByteRing commit and consume", "[byte_ring]") {
+  size_t memory_before = reactor.current_memory();
+  {
+    auto ring_res = ByteRing::make(reactor.allocator(), 12);
+    COROSIG_REQUIRE(ring_res);
+    ByteRing ring = std::move(ring_res.value());
+
+    COROSIG_REQUIRE(ring.capacity() == 16);
+    COROSIG_REQUIRE(!ring.is_mirrored());
+    COROSIG_REQUIRE(ring.empty());
+    COROSIG_REQUIRE(ring.writable().size() == 16);
+
+    produce(ring, "hello");
+    COROSIG_REQUIRE(ring.size() == 5);
+    COROSIG_REQUIRE(ring.free_space() == 11);
+    COROSIG_REQUIRE(std::string_view{ring.readable().data(), ring.readable().size()} == "hello");
+
+    ring.consume(2);
+    COROSIG_REQUIRE(std::string_view{ring.readable().data(), ring.readable().size()} == "llo");
+
+    // a span taken before the ring empties stays where commit puts data
+    std::span<char> free = ring.writable();
+    ring.consume(3);
+    COROSIG_REQUIRE(ring.empty());
+    COROSIG_REQUIRE(ring.writable().data() == free.data());
+    COROSIG_REQUIRE(ring.writable_parts()[0].size() + ring.writable_parts()[1].size() == 16);
+
+    free[0] = '!';
+    ring.commit(1);
+    COROSIG_REQUIRE(std::string_view{ring.readable().data(), ring.readable().size()} == "!");
+
+    ring.clear();
+    COROSIG_REQUIRE(ring.writable().size() == 16);
+  }
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("ByteRing splits wrapped data into two parts", "[byte_ring]") {
+  auto ring_res = ByteRing::make(reactor.allocator(), 8);
+  COROSIG_REQUIRE(ring_res);
+  ByteRing ring = std::move(ring_res.value());
+
+  produce(ring, "abcdef");
+  ring.consume(4);
+  COROSIG_REQUIRE(ring.writable().size() == 2);
+  COROSIG_REQUIRE(ring.writable_parts()[1].size() == 4);
+
+  auto free_parts = ring.writable_parts();
+  std::ranges::copy(std::string_view{"gh"}, free_parts[0].begin());
+  std::ranges::copy(std::string_view{"ij"}, free_parts[1].begin());
+  ring.commit(4);
+
+  COROSIG_REQUIRE(ring.size() == 6);
+  auto parts = ring.readable_parts();
+  COROSIG_REQUIRE(std::string_view{parts[0].data(), parts[0].size()} == "efgh");
+  COROSIG_REQUIRE(std::string_view{parts[1].data(), parts[1].size()} == "ij");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("ByteRing reports allocation failure", "[byte_ring]") {
+  Allocator::Memory<64> mem;
+  Allocator alloc{mem};
+  COROSIG_REQUIRE(!ByteRing::make(alloc, 1024));
+}
+
+TEST_CASE("Mirrored ByteRing keeps wrapped data contiguous", "[byte_ring]") {
+  auto ring_res = ByteRing::make_mirrored(1);
+  REQUIRE(ring_res);
+  ByteRing ring = std::move(ring_res.value());
+  REQUIRE(ring.is_mirrored());
+  REQUIRE(ring.capacity() >= 4096);
+
+  size_t const cap = ring.capacity();
+  std::span<char> free = ring.writable();
+  REQUIRE(free.size() == cap);
+  std::memset(free.data(), 'x', cap - 2);
+  ring.commit(cap - 2);
+  ring.consume(cap - 4);
+
+  produce(ring, "wrap");
+  std::span<char const> data = ring.readable();
+  REQUIRE(std::string_view{data.data(), data.size()} == "xxwrap");
+  REQUIRE(ring.readable_parts()[1].empty());
+  REQUIRE(ring.writable().size() == cap - 6);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("ByteRing fills from reader and drains to writer", "[byte_ring]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    COROSIG_CO_TRY(auto ring, ByteRing::make(r.allocator(), 16));
+
+    COROSIG_CO_TRYV(co_await pipes.write.write(r, "streamed"));
+    COROSIG_CO_TRY(size_t read, co_await ring.fill_from(r, pipes.read));
+    COROSIG_REQUIRE(read == 8);
+    COROSIG_REQUIRE(ring.size() == 8);
+
+    COROSIG_CO_TRY(size_t written, co_await ring.drain_to(r, pipes.write));
+    COROSIG_REQUIRE(written == 8);
+    COROSIG_REQUIRE(ring.empty());
+
+    COROSIG_CO_TRY(read, ring.try_fill_from(pipes.read));
+    COROSIG_REQUIRE(read == 8);
+    std::span<char const> data = ring.readable();
+    COROSIG_REQUIRE(std::string_view{data.data(), data.size()} == "streamed");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
@@ -0,0 +1,183 @@
+#include "corosig/container/FlatHashMap.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/LifetimeCounter.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+using namespace corosig;
+using namespace corosig::testing;
+
+struct LifetimeCounterResetListener : Catch::EventListenerBase {
+  using Catch::EventListenerBase::EventListenerBase;
+
+  void testCaseStarting(Catch::TestCaseInfo const &) override {
+    LifetimeCounter::reset();
+  }
+};
+
+CATCH_REGISTER_LISTENER(LifetimeCounterResetListener);
+
+struct CollidingHash {
+  size_t operator()(int) const noexcept {
+    return 42;
+  }
+};
+
+} // namespace
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap starts empty and does not allocate", "[flat_hash_map]") {
+  size_t memory_before = reactor.current_memory();
+  FlatHashMap<int, int> map{reactor.allocator()};
+  COROSIG_REQUIRE(map.empty());
+  COROSIG_REQUIRE(map.capacity() == 0);
+  COROSIG_REQUIRE(map.find(1) == map.end());
+  COROSIG_REQUIRE(!map.contains(1));
+  COROSIG_REQUIRE(map.erase(1) == 0);
+  COROSIG_REQUIRE(map.begin() == map.end());
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap insert and find", "[flat_hash_map]") {
+  FlatHashMap<int, int> map{reactor.allocator()};
+  for (int i = 0; i < 100; ++i) {
+    auto res = map.try_emplace(i, i * 10);
+    COROSIG_REQUIRE(res);
+    COROSIG_REQUIRE(res.value().second);
+  }
+  COROSIG_REQUIRE(map.size() == 100);
+
+  auto again = map.try_emplace(5, 0);
+  COROSIG_REQUIRE(again);
+  COROSIG_REQUIRE(!again.value().second);
+  COROSIG_REQUIRE(again.value().first->second == 50);
+
+  for (int i = 0; i < 100; ++i) {
+    auto it = map.find(i);
+    COROSIG_REQUIRE(it != map.end());
+    COROSIG_REQUIRE(it->first == i);
+    COROSIG_REQUIRE(it->second == i * 10);
+  }
+  COROSIG_REQUIRE(!map.contains(100));
+
+  size_t iterated = 0;
+  for (auto const &[key, value] : map) {
+    COROSIG_REQUIRE(value == key * 10);
+    ++iterated;
+  }
+  COROSIG_REQUIRE(iterated == 100);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap heterogeneous lookup with string_view keys",
+                             "[flat_hash_map]") {
+  FlatHashMap<std::string_view, int> map{reactor.allocator()};
+  COROSIG_REQUIRE(map.try_emplace("example.com", 1));
+  COROSIG_REQUIRE(map.try_emplace("localhost", 2));
+  COROSIG_REQUIRE(map.insert_or_assign("localhost", 3));
+
+  char const name[] = "example.com";
+  COROSIG_REQUIRE(map.find(std::string_view{name})->second == 1);
+  COROSIG_REQUIRE(map.find(std::string_view{"localhost"})->second == 3);
+  COROSIG_REQUIRE(map.size() == 2);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap erase leaves other elements reachable",
+                             "[flat_hash_map]") {
+  FlatHashMap<int, int, CollidingHash> map{reactor.allocator()};
+  for (int i = 0; i < 40; ++i) {
+    COROSIG_REQUIRE(map.try_emplace(i, i));
+  }
+  for (int i = 0; i < 40; i += 2) {
+    COROSIG_REQUIRE(map.erase(i) == 1);
+  }
+  COROSIG_REQUIRE(map.size() == 20);
+  for (int i = 0; i < 40; ++i) {
+    COROSIG_REQUIRE(map.contains(i) == (i % 2 == 1));
+  }
+
+  // reuse freed slots
+  for (int i = 0; i < 40; i += 2) {
+    COROSIG_REQUIRE(map.try_emplace(i, -i));
+  }
+  COROSIG_REQUIRE(map.size() == 40);
+  COROSIG_REQUIRE(map.find(8)->second == -8);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap destroys elements", "[flat_hash_map]") {
+  {
+    FlatHashMap<int, LifetimeCounter> map{reactor.allocator()};
+    for (int i = 0; i < 30; ++i) {
+      COROSIG_REQUIRE(map.try_emplace(i, i));
+    }
+    COROSIG_REQUIRE(map.erase(3) == 1);
+    COROSIG_REQUIRE(LifetimeCounter::destructed == 1);
+  }
+  COROSIG_REQUIRE(LifetimeCounter::constructed == 30);
+  COROSIG_REQUIRE(LifetimeCounter::destructed == 30);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap reports allocation failure", "[flat_hash_map]") {
+  Allocator::Memory<256> mem;
+  Allocator alloc{mem};
+  FlatHashMap<int, int> map{alloc};
+  COROSIG_REQUIRE(!map.reserve(1000));
+
+  bool failed = false;
+  for (int i = 0; i < 1000 && !failed; ++i) {
+    failed = !map.try_emplace(i, i);
+  }
+  COROSIG_REQUIRE(failed);
+  for (auto const &[key, value] : map) {
+    COROSIG_REQUIRE(key == value);
+  }
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("FlatHashMap reserve prevents rehash", "[flat_hash_map]") {
+  FlatHashMap<int, int> map{reactor.allocator()};
+  COROSIG_REQUIRE(map.reserve(50));
+  size_t capacity = map.capacity();
+  COROSIG_REQUIRE(capacity >= 50);
+  for (int i = 0; i < 50; ++i) {
+    COROSIG_REQUIRE(map.try_emplace(i, i));
+  }
+  COROSIG_REQUIRE(map.capacity() == capacity);
+}
+
+TEST_CASE("FlatHashMap behaves like std::unordered_map", "[flat_hash_map]") {
+  constexpr size_t MEMORY = static_cast<size_t>(1024) * 1024;
+  auto mem = std::make_unique<Allocator::Memory<MEMORY>>();
+  Allocator alloc{*mem};
+  {
+    FlatHashMap<int, int> map{alloc};
+    std::unordered_map<int, int> reference;
+
+    std::mt19937 rng{1234}; // NOLINT
+    std::uniform_int_distribution<int> keys{0, 500};
+    for (size_t i = 0; i < 20000; ++i) {
+      int key = keys(rng);
+      if (rng() % 3 == 0) {
+        REQUIRE(map.erase(key) == reference.erase(key));
+      } else {
+        auto res = map.try_emplace(key, key + 1);
+        REQUIRE(res);
+        REQUIRE(res.value().second == reference.emplace(key, key + 1).second);
+      }
+      REQUIRE(map.size() == reference.size());
+    }
+
+    for (int key = 0; key <= 500; ++key) {
+      REQUIRE(map.contains(key) == reference.contains(key));
+    }
+  }
+  REQUIRE(alloc.current_memory() == 0);
+}
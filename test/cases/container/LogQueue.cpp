@@ -0,0 +1,199 @@
+#include "corosig/container/LogQueue.hpp"
+
+#include "corosig/io/Pipe.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <cerrno>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace corosig;
+
+namespace {
+
+std::string_view as_string(std::span<char const> record) {
+  return std::string_view{record.data(), record.size()};
+}
+
+LogQueue<8, 32> g_queue;
+
+/// Accepts a fixed amount of records and then fails like a full disk
+struct LimitedWriter {
+  size_t left;
+  std::array<char, 64> text;
+  size_t size;
+
+  std::string_view written() const noexcept {
+    return std::string_view{text.data(), size};
+  }
+
+  Fut<void, Error<AllocationError, SyscallError>> write(Reactor &,
+                                                        std::span<char const> record) noexcept {
+    if (left == 0) {
+      co_return Failure{SyscallError{ENOSPC}};
+    }
+    --left;
+    std::memcpy(text.data() + size, record.data(), record.size());
+    size += record.size();
+    co_return Ok{};
+  }
+};
+
+} // namespace
+
+TEST_CASE("LogQueue keeps records in order", "[log_queue]") {
+  LogQueue<4, 8> queue;
+  REQUIRE(!queue.front());
+
+  REQUIRE(queue.push("first"));
+  REQUIRE(queue.push("second"));
+  REQUIRE(!queue.push("too long record"));
+
+  REQUIRE(as_string(*queue.front()) == "first");
+  queue.pop();
+  REQUIRE(as_string(*queue.front()) == "second");
+  queue.pop();
+  REQUIRE(!queue.front());
+
+  for (size_t i = 0; i < queue.capacity(); ++i) {
+    REQUIRE(queue.push("x"));
+  }
+  REQUIRE(!queue.push("y"));
+  REQUIRE(queue.dropped() == 2);
+
+  queue.pop();
+  REQUIRE(queue.push("y"));
+}
+
+TEST_CASE("LogQueue skips records which were reserved but never committed", "[log_queue]") {
+  LogQueue<4, 8> queue;
+
+  std::optional torn = queue.reserve();
+  REQUIRE(torn);
+  std::memcpy(torn->buffer.data(), "half", 4);
+  REQUIRE(queue.push("whole"));
+
+  // consumer does not see past an uncommitted record on its own
+  REQUIRE(!queue.front());
+  REQUIRE(queue.skip_torn() == 1);
+  REQUIRE(as_string(*queue.front()) == "whole");
+  REQUIRE(queue.skip_torn() == 0);
+  queue.pop();
+
+  // producer which comes back late is told its record is lost
+  REQUIRE(!queue.commit(*torn, 4));
+  REQUIRE(!queue.front());
+  REQUIRE(queue.dropped() == 1);
+}
+
+TEST_CASE("LogQueue ignores late commit into a reused cell", "[log_queue]") {
+  LogQueue<4, 8> queue;
+
+  std::optional torn = queue.reserve();
+  REQUIRE(torn);
+  REQUIRE(queue.skip_torn() == 1);
+  for (size_t i = 1; i < queue.capacity(); ++i) {
+    REQUIRE(queue.push("x"));
+    queue.pop();
+  }
+
+  std::optional fresh = queue.reserve();
+  REQUIRE(fresh);
+  REQUIRE(fresh->buffer.data() == torn->buffer.data());
+  std::memcpy(fresh->buffer.data(), "fresh", 5);
+  REQUIRE(queue.commit(*fresh, 5));
+
+  REQUIRE(!queue.commit(*torn, 1));
+  REQUIRE(as_string(*queue.front()) == "fresh");
+}
+
+TEST_CASE("LogQueue takes records from many producers", "[log_queue]") {
+  LogQueue<64, 16> queue;
+  constexpr size_t PRODUCERS = 4;
+  constexpr size_t RECORDS = 10000;
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < PRODUCERS; ++p) {
+    producers.emplace_back([&queue, p] {
+      std::string record(16, static_cast<char>('a' + p));
+      for (size_t i = 0; i < RECORDS; ++i) {
+        while (!queue.push(record)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::array<size_t, PRODUCERS> received{};
+  size_t total = 0;
+  bool intact = true;
+  while (total < PRODUCERS * RECORDS) {
+    std::optional record = queue.front();
+    if (!record) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::string_view text = as_string(*record);
+    intact = intact && text.size() == 16 && text.find_first_not_of(text[0]) == text.npos;
+    ++received[static_cast<size_t>(text[0] - 'a')];
+    queue.pop();
+    ++total;
+  }
+
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  REQUIRE(intact);
+  for (size_t count : received) {
+    REQUIRE(count == RECORDS);
+  }
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("LogQueue is drained into a pipe", "[log_queue]") {
+  COROSIG_REQUIRE(g_queue.push("one\n"));
+  COROSIG_REQUIRE(g_queue.reserve());
+  COROSIG_REQUIRE(g_queue.push("two\n"));
+
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipe, PipePair::make());
+    COROSIG_CO_TRY(size_t written, co_await g_queue.drain_to(r, pipe.write));
+    COROSIG_REQUIRE(written == 2);
+    COROSIG_REQUIRE(g_queue.dropped() == 1);
+
+    std::array<char, 16> buf;
+    COROSIG_CO_TRY(size_t read, pipe.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view(buf.data(), read) == "one\ntwo\n");
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("LogQueue keeps only unwritten records after a failed drain",
+                             "[log_queue]") {
+  static LogQueue<8, 32> queue;
+  static LimitedWriter writer{.left = 2, .text = {}, .size = 0};
+  COROSIG_REQUIRE(queue.push("one"));
+  COROSIG_REQUIRE(queue.push("two"));
+  COROSIG_REQUIRE(queue.push("three"));
+
+  auto res = queue.drain_to(reactor, writer).block_on();
+  COROSIG_REQUIRE(!res);
+  COROSIG_REQUIRE(res.error().holds<SyscallError>());
+  COROSIG_REQUIRE(res.error().as<SyscallError>().value == ENOSPC);
+  COROSIG_REQUIRE(writer.written() == "onetwo");
+
+  writer.left = 1;
+  auto rest = queue.drain_to(reactor, writer).block_on();
+  COROSIG_REQUIRE(rest);
+  COROSIG_REQUIRE(rest.value() == 1);
+  COROSIG_REQUIRE(writer.written() == "onetwothree");
+}
@@ -0,0 +1,70 @@
+#include "corosig/container/MemoryResource.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+using namespace corosig;
+
+COROSIG_SIGHANDLER_TEST_CASE("MemoryResource allocates from reactor memory", "[MemoryResource]") {
+  MemoryResource resource{reactor.allocator()};
+
+  size_t memory_before = reactor.current_memory();
+  {
+    std::pmr::vector<int> ints{&resource};
+    for (int i = 0; i < 100; ++i) {
+      ints.push_back(i);
+    }
+    COROSIG_REQUIRE(reactor.allocator().owns(ints.data()));
+    COROSIG_REQUIRE(reactor.current_memory() > memory_before);
+  }
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+  COROSIG_REQUIRE(!resource.failed());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("MemoryResource returns nullptr on failure by default",
+                             "[MemoryResource]") {
+  Allocator::Memory<256> mem;
+  Allocator alloc{mem};
+  MemoryResource resource{alloc};
+
+  COROSIG_REQUIRE(resource.allocate(4096) == nullptr);
+  COROSIG_REQUIRE(resource.failed());
+  COROSIG_REQUIRE(resource.failed_allocations() == 1);
+
+  void *p = resource.allocate(16);
+  COROSIG_REQUIRE(p != nullptr);
+  resource.deallocate(p, 16);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("MemoryResource respects alignment", "[MemoryResource]") {
+  MemoryResource resource{reactor.allocator()};
+  void *p = resource.allocate(64, 64);
+  COROSIG_REQUIRE(p != nullptr);
+  COROSIG_REQUIRE(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+  resource.deallocate(p, 64, 64);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("MemoryResource is equal only to itself", "[MemoryResource]") {
+  MemoryResource first{reactor.allocator()};
+  MemoryResource second{reactor.allocator()};
+  COROSIG_REQUIRE(first.is_equal(first));
+  COROSIG_REQUIRE(!first.is_equal(second));
+}
+
+TEST_CASE("MemoryResource may throw on failure", "[MemoryResource]") {
+  Allocator::Memory<256> mem;
+  Allocator alloc{mem};
+  MemoryResource resource{alloc, OnAllocationFailure::THROW_BAD_ALLOC};
+
+  std::pmr::vector<char> chars{&resource};
+  REQUIRE_THROWS_AS(chars.resize(4096), std::bad_alloc);
+  REQUIRE(resource.failed_allocations() == 1);
+}
@@ -0,0 +1,65 @@
+#include "corosig/container/NewInterposition.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <new>
+#include <vector>
+
+COROSIG_DEFINE_GLOBAL_NEW_INTERPOSITION();
+
+using namespace corosig;
+
+COROSIG_SIGHANDLER_TEST_CASE("Interposed operator new allocates from reactor memory",
+                             "[NewInterposition]") {
+  size_t memory_before = reactor.current_memory();
+  {
+    ScopedNewInterposition interposition{reactor.allocator()};
+    auto value = std::make_unique<int>(42);
+    COROSIG_REQUIRE(reactor.allocator().owns(value.get()));
+    COROSIG_REQUIRE(interposition.allocations() == 1);
+    COROSIG_REQUIRE(interposition.allocated_bytes() == sizeof(int));
+  }
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Interposed operator new reports exhaustion", "[NewInterposition]") {
+  Allocator::Memory<256> mem;
+  Allocator alloc{mem};
+
+  ScopedNewInterposition interposition{alloc};
+  void *p = ::operator new(4096, std::nothrow);
+  COROSIG_REQUIRE(p == nullptr);
+  COROSIG_REQUIRE(interposition.failed_allocations() == 1);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Interpositions nest", "[NewInterposition]") {
+  Allocator::Memory<256> mem;
+  Allocator inner_alloc{mem};
+
+  ScopedNewInterposition outer{reactor.allocator()};
+  auto *outer_value = new int{1};
+  {
+    ScopedNewInterposition inner{inner_alloc};
+    auto *inner_value = new int{2};
+    COROSIG_REQUIRE(inner_alloc.owns(inner_value));
+    // memory of outer interposition is still returned to it's allocator
+    delete outer_value;
+    delete inner_value;
+    COROSIG_REQUIRE(inner.allocations() == 1);
+  }
+  COROSIG_REQUIRE(outer.allocations() == 1);
+}
+
+TEST_CASE("Without interposition operator new uses global heap", "[NewInterposition]") {
+  Allocator::Memory<256> mem;
+  Allocator alloc{mem};
+  std::vector<int> values(1000, 1);
+  REQUIRE(!alloc.owns(values.data()));
+
+  auto aligned = std::make_unique<std::aligned_storage_t<256, 128>>();
+  REQUIRE(reinterpret_cast<uintptr_t>(aligned.get()) % 128 == 0);
+}
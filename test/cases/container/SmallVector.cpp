@@ -0,0 +1,158 @@
+#include "corosig/container/SmallVector.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/LifetimeCounter.hpp"
+#include "corosig/testing/NonCopyable.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <utility>
+
+namespace {
+
+using namespace corosig;
+using namespace corosig::testing;
+
+struct LifetimeCounterResetListener : Catch::EventListenerBase {
+  using Catch::EventListenerBase::EventListenerBase;
+
+  void testCaseStarting(Catch::TestCaseInfo const &) override {
+    LifetimeCounter::reset();
+  }
+};
+
+CATCH_REGISTER_LISTENER(LifetimeCounterResetListener);
+
+} // namespace
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector does not allocate within inline capacity",
+                             "[small_vector]") {
+  size_t memory_before = reactor.current_memory();
+  {
+    SmallVector<LifetimeCounter, 4> v{reactor.allocator()};
+    COROSIG_REQUIRE(v.empty());
+    COROSIG_REQUIRE(v.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+      COROSIG_REQUIRE(v.push_back(LifetimeCounter{i}));
+    }
+    COROSIG_REQUIRE(v.is_inline());
+    COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+    COROSIG_REQUIRE(v[3] == 3);
+  }
+  COROSIG_REQUIRE(LifetimeCounter::constructed == 4);
+  COROSIG_REQUIRE(LifetimeCounter::destructed == 4);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector spills to allocator on overflow", "[small_vector]") {
+  size_t memory_before = reactor.current_memory();
+  {
+    SmallVector<LifetimeCounter, 2> v{reactor.allocator()};
+    for (int i = 0; i < 5; ++i) {
+      COROSIG_REQUIRE(v.push_back(LifetimeCounter{i}));
+    }
+    COROSIG_REQUIRE(!v.is_inline());
+    COROSIG_REQUIRE(v.capacity() >= 5);
+    COROSIG_REQUIRE(reactor.current_memory() > memory_before);
+    for (int i = 0; i < 5; ++i) {
+      COROSIG_REQUIRE(v[i] == i);
+    }
+  }
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+  COROSIG_REQUIRE(LifetimeCounter::constructed == 5);
+  COROSIG_REQUIRE(LifetimeCounter::destructed == 5);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector reports allocation failure", "[small_vector]") {
+  Allocator::Memory<64> mem;
+  Allocator alloc{mem};
+  SmallVector<int, 2> v{alloc};
+  COROSIG_REQUIRE(v.push_back(1));
+  COROSIG_REQUIRE(v.push_back(2));
+  COROSIG_REQUIRE(!v.reserve(1000));
+  COROSIG_REQUIRE(v.size() == 2);
+  COROSIG_REQUIRE(v.is_inline());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector move of inline storage moves elements",
+                             "[small_vector]") {
+  SmallVector<NonCopyable, 3> v{reactor.allocator()};
+  COROSIG_REQUIRE(v.push_back(NonCopyable{1}));
+  COROSIG_REQUIRE(v.push_back(NonCopyable{2}));
+
+  SmallVector<NonCopyable, 3> moved{std::move(v)};
+  COROSIG_REQUIRE(v.empty());
+  COROSIG_REQUIRE(moved.is_inline());
+  COROSIG_REQUIRE(moved.size() == 2);
+  COROSIG_REQUIRE(moved[0].value == 1);
+  COROSIG_REQUIRE(moved[1].value == 2);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector move of heap storage steals buffer", "[small_vector]") {
+  SmallVector<int, 1> v{reactor.allocator()};
+  for (int i = 0; i < 3; ++i) {
+    COROSIG_REQUIRE(v.push_back(i));
+  }
+  int const *data = v.data();
+
+  SmallVector<int, 1> moved{reactor.allocator()};
+  moved = std::move(v);
+  COROSIG_REQUIRE(moved.data() == data);
+  COROSIG_REQUIRE(moved.size() == 3);
+  COROSIG_REQUIRE(v.empty());
+  COROSIG_REQUIRE(v.is_inline());
+  COROSIG_REQUIRE(v.push_back(42));
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector shrink_to_fit returns to inline storage",
+                             "[small_vector]") {
+  size_t memory_before = reactor.current_memory();
+  SmallVector<int, 4> v{reactor.allocator()};
+  for (int i = 0; i < 10; ++i) {
+    COROSIG_REQUIRE(v.push_back(i));
+  }
+  v.erase(v.begin() + 1, v.end() - 1);
+  COROSIG_REQUIRE(v.size() == 2);
+  COROSIG_REQUIRE(v[0] == 0);
+  COROSIG_REQUIRE(v[1] == 9);
+
+  COROSIG_REQUIRE(v.shrink_to_fit());
+  COROSIG_REQUIRE(v.is_inline());
+  COROSIG_REQUIRE(v.capacity() == 4);
+  COROSIG_REQUIRE(reactor.current_memory() == memory_before);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector insert and resize", "[small_vector]") {
+  SmallVector<int, 4> v{reactor.allocator()};
+  COROSIG_REQUIRE(v.resize(3, 7));
+  COROSIG_REQUIRE(v.size() == 3);
+
+  std::array values{1, 2, 3};
+  auto it = v.insert(v.begin() + 1, values);
+  COROSIG_REQUIRE(it);
+  COROSIG_REQUIRE(*it.value() == 1);
+  COROSIG_REQUIRE(v.size() == 6);
+
+  std::array expected{7, 1, 2, 3, 7, 7};
+  COROSIG_REQUIRE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+  COROSIG_REQUIRE(v.resize(1));
+  COROSIG_REQUIRE(v.size() == 1);
+  COROSIG_REQUIRE(v.front() == 7);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("SmallVector clone produces a deep copy", "[small_vector]") {
+  SmallVector<int, 2> v{reactor.allocator()};
+  COROSIG_REQUIRE(v.push_back(5));
+  COROSIG_REQUIRE(v.push_back(7));
+  COROSIG_REQUIRE(v.push_back(9));
+
+  auto cloned = v.clone();
+  COROSIG_REQUIRE(cloned);
+  COROSIG_REQUIRE(cloned.value().size() == 3);
+  COROSIG_REQUIRE(cloned.value()[2] == 9);
+  COROSIG_REQUIRE(cloned.value().data() != v.data());
+}
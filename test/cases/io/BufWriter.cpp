@@ -0,0 +1,153 @@
+#include "corosig/io/BufWriter.hpp"
+
+#include "corosig/container/Allocator.hpp"
+#include "corosig/Sleep.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <fcntl.h>
+#include <format>
+#include <string>
+#include <string_view>
+
+using namespace corosig;
+
+COROSIG_SIGHANDLER_TEST_CASE("BufWriter coalesces small writes until flush", "[BufWriter]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 64};
+
+    COROSIG_CO_TRYV(co_await out.write(r, "hello"));
+    COROSIG_CO_TRYV(co_await out.write(r, ", "));
+    COROSIG_CO_TRYV(co_await out.write(r, "world"));
+    COROSIG_REQUIRE(out.buffered().size() == 12);
+
+    std::array<char, 64> buf;
+    auto nothing = pipes.read.try_read_some(buf);
+    COROSIG_REQUIRE(!nothing);
+    COROSIG_REQUIRE(nothing.error().value == EAGAIN);
+
+    COROSIG_CO_TRYV(co_await out.flush(r));
+    COROSIG_REQUIRE(out.buffered().empty());
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "hello, world");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("BufWriter flushes once buffer is full", "[BufWriter]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 8};
+
+    COROSIG_CO_TRYV(co_await out.write(r, "12345"));
+    COROSIG_CO_TRYV(co_await out.write(r, "6789"));
+    COROSIG_REQUIRE(std::string_view{out.buffered().data(), out.buffered().size()} == "6789");
+
+    std::array<char, 16> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "12345");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("BufWriter passes large writes through", "[BufWriter]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 8};
+
+    COROSIG_CO_TRYV(co_await out.write(r, "head:"));
+    COROSIG_CO_TRYV(co_await out.write(r, "a payload longer than the buffer"));
+    COROSIG_REQUIRE(out.buffered().empty());
+
+    std::array<char, 64> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "head:a payload longer than the buffer");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("BufWriter is an output iterator for format_to", "[BufWriter]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    BufWriter out{std::move(pipes.write), r.allocator(), 16};
+
+    std::format_to(out.out(), "signal {} at {:#x}", 11, 0xdead);
+    COROSIG_CO_TRYV(co_await out.flush(r));
+
+    std::array<char, 64> buf;
+    COROSIG_CO_TRY(size_t read, pipes.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "signal 11 at 0xdead");
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("BufWriter reports allocation failure", "[BufWriter]") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipes, PipePair::make());
+    Allocator::Memory<64> mem;
+    Allocator alloc{mem};
+    BufWriter out{std::move(pipes.write), alloc, 1024};
+
+    auto res = co_await out.write(r, "data");
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<AllocationError>());
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+TEST_CASE("BufWriter keeps unwritten bytes and the real error of the sink", "[BufWriter]") {
+  // Writing into a pipe without readers must fail with EPIPE instead of killing the process
+  auto old_handler = std::signal(SIGPIPE, SIG_IGN);
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(auto pipes, PipePair::make());
+      constexpr size_t PIPE_CAPACITY = 4096;
+      COROSIG_REQUIRE(::fcntl(pipes.write.underlying_handle(), F_SETPIPE_SZ, PIPE_CAPACITY) != -1);
+      // more than reactor of a test handler has
+      static Allocator::Memory<16384> mem;
+      Allocator alloc{mem};
+      BufWriter out{std::move(pipes.write), alloc, 8192};
+
+      static std::string const data(6000, 'x');
+      COROSIG_CO_TRYV(co_await out.write(r, data));
+
+      // reader goes away only after the pipe is filled by the first writev
+      auto closing = [](Reactor &,
+                        PipeRead read) -> Fut<void, Error<AllocationError, SyscallError>> {
+        co_await Sleep{std::chrono::milliseconds{20}};
+        PipeRead closed = std::move(read);
+        co_return Ok{};
+      }(r, std::move(pipes.read));
+
+      auto res = co_await out.flush(r);
+      COROSIG_REQUIRE(!res);
+      COROSIG_REQUIRE(res.error().holds<SyscallError>());
+      COROSIG_REQUIRE(res.error().as<SyscallError>().value == EPIPE);
+      COROSIG_REQUIRE(out.buffered().size() == data.size() - PIPE_CAPACITY);
+      COROSIG_CO_TRYV(co_await std::move(closing));
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  (void)std::signal(SIGPIPE, old_handler);
+}
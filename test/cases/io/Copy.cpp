@@ -0,0 +1,163 @@
+#include "corosig/io/Copy.hpp"
+
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/io/UnixSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+#include "corosig/testing/SocketHelpers.hpp"
+#include "corosig/testing/TemporaryFileTestListener.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <span>
+#include <thread>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+CATCH_REGISTER_LISTENER(TemporaryFileTestListener);
+
+/// Takes a fixed amount of bytes, writing short once it is nearly reached, and then fails like a
+/// full disk
+struct LimitedWriter {
+  size_t left;
+
+  Fut<size_t, Error<AllocationError, SyscallError>> write(Reactor &,
+                                                          std::span<char const> buf) noexcept {
+    co_return try_write_some(buf);
+  }
+
+  Fut<size_t, Error<AllocationError, SyscallError>> write_some(Reactor &,
+                                                               std::span<char const> buf) noexcept {
+    co_return try_write_some(buf);
+  }
+
+  Result<size_t, SyscallError> try_write_some(std::span<char const> buf) noexcept {
+    if (left == 0) {
+      return Failure{SyscallError{ENOSPC}};
+    }
+    size_t n = std::min(buf.size(), left);
+    left -= n;
+    return n;
+  }
+};
+
+} // namespace
+
+TEST_CASE("copy sends rest of a file into TcpSocket") {
+  constexpr static uint16_t PORT = 5571;
+
+  std::string content = make_content(20000);
+  write_temp_file(content);
+
+  std::string received;
+  std::thread server = start_collecting_server(PORT, received);
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(auto file, co_await File::open(r, g_temp_test_file, File::OpenFlags::RDONLY));
+      COROSIG_CO_TRY(auto sock,
+                     co_await TcpSocket::connect(r, Ipv4Addr::loopback().to_sockaddr(PORT)));
+
+      std::array<char, 100> head;
+      COROSIG_CO_TRYV(co_await file.read(r, head));
+      COROSIG_CO_TRY(size_t copied, co_await copy(r, file, sock));
+      COROSIG_REQUIRE(copied == 19900);
+
+      // offset is moved to the end
+      COROSIG_CO_TRY(size_t read, co_await file.read(r, head));
+      COROSIG_REQUIRE(read == 0);
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  server.join();
+  REQUIRE(received == content.substr(100));
+}
+
+TEST_CASE("copy moves a file through a unix stream with double buffering") {
+  static std::string content = make_content(50000);
+  write_temp_file(content);
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(auto file, co_await File::open(r, g_temp_test_file, File::OpenFlags::RDONLY));
+      COROSIG_CO_TRY(auto pair, UnixStream::make_pair());
+
+      // socket buffer can't hold the whole file, so reading side has to keep up concurrently
+      auto reading = [](Reactor &r,
+                        UnixStream &from) -> Fut<size_t, Error<AllocationError, SyscallError>> {
+        size_t total = 0;
+        std::array<char, 512> buf;
+        while (true) {
+          COROSIG_CO_TRY(size_t n, co_await from.read_some(r, buf));
+          if (n == 0) {
+            break;
+          }
+          for (size_t i = 0; i < n; ++i) {
+            COROSIG_REQUIRE(buf[i] == content[total + i]);
+          }
+          total += n;
+        }
+        co_return total;
+      }(r, pair[1]);
+
+      COROSIG_CO_TRY(size_t copied, co_await copy(r, file, pair[0], 1024));
+      COROSIG_REQUIRE(copied == content.size());
+      pair[0].close();
+
+      COROSIG_CO_TRY(size_t received, co_await std::move(reading));
+      COROSIG_REQUIRE(received == content.size());
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("copy splices a pipe into another one") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto first, PipePair::make());
+    COROSIG_CO_TRY(auto second, PipePair::make());
+
+    constexpr std::string_view MSG = "copied between pipes";
+    COROSIG_CO_TRYV(co_await first.write.write(r, MSG));
+    first.write.close();
+
+    COROSIG_CO_TRY(size_t copied, co_await copy(r, first.read, second.write));
+    COROSIG_REQUIRE(copied == MSG.size());
+
+    std::array<char, 64> buf;
+    COROSIG_CO_TRY(size_t read, second.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == MSG);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("copy returns the error of a writer which took only a part") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pipe, PipePair::make());
+    COROSIG_CO_TRYV(co_await pipe.write.write(r, "does not fit into writer"));
+    pipe.write.close();
+
+    LimitedWriter writer{.left = 4};
+    auto res = co_await copy(r, pipe.read, writer);
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<SyscallError>());
+    COROSIG_REQUIRE(res.error().as<SyscallError>().value == ENOSPC);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
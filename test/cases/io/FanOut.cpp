@@ -0,0 +1,132 @@
+#include "corosig/io/FanOut.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Parallel.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/UdpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+#include "corosig/testing/TemporaryFileTestListener.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <fcntl.h>
+#include <span>
+#include <string>
+#include <string_view>
+
+using namespace corosig;
+using namespace corosig::testing;
+using namespace std::chrono_literals;
+
+namespace {
+
+CATCH_REGISTER_LISTENER(TemporaryFileTestListener);
+
+constexpr std::array<std::span<char const>, 3> LOGS{
+    std::string_view{"first log\n"},
+    std::string_view{"second log\n"},
+    std::string_view{"third log\n"},
+};
+
+std::array<char, size_t{256} * 1024> g_large{};
+
+} // namespace
+
+TEST_CASE("fan_out writes the same logs into a file, a pipe and a udp socket") {
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError, TimedOutError>> {
+      COROSIG_CO_TRY(File file,
+                     co_await File::open(
+                         r, g_temp_test_file, File::OpenFlags::CREATE | File::OpenFlags::WRONLY));
+      COROSIG_CO_TRY(auto pipe, PipePair::make());
+      COROSIG_CO_TRY(auto receiver, UdpSocket::bound(Ipv4Addr::loopback().to_sockaddr()));
+      COROSIG_CO_TRY(auto receiver_addr, receiver.address());
+      COROSIG_CO_TRY(auto sender, UdpSocket::unbound());
+
+      FanOutSink to_file{file};
+      FanOutSink to_pipe{pipe.write};
+      FanOutSink to_udp{sender, {}, &receiver_addr};
+      COROSIG_CO_TRYV(co_await fan_out(r, LOGS, to_file, to_pipe, to_udp));
+
+      size_t total = LOGS[0].size() + LOGS[1].size() + LOGS[2].size();
+      COROSIG_REQUIRE(to_file.progress == total);
+      COROSIG_REQUIRE(to_pipe.progress == total);
+      COROSIG_REQUIRE(to_udp.progress == total);
+
+      std::array<char, 64> buf;
+      COROSIG_CO_TRY(size_t read, pipe.read.try_read_some(buf));
+      COROSIG_REQUIRE(std::string_view(buf.data(), read) == "first log\nsecond log\nthird log\n");
+
+      // every chunk is a separate datagram
+      for (std::span<char const> log : LOGS) {
+        COROSIG_CO_TRY(read, co_await receiver.recv_from(r, buf));
+        COROSIG_REQUIRE(std::string_view(buf.data(), read) ==
+                        std::string_view(log.data(), log.size()));
+      }
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  REQUIRE(read_file(g_temp_test_file) == "first log\nsecond log\nthird log\n");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("fan_out splits chunks longer than a udp datagram") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError, TimedOutError>> {
+    COROSIG_CO_TRY(auto receiver, UdpSocket::bound(Ipv4Addr::loopback().to_sockaddr()));
+    COROSIG_CO_TRY(auto receiver_addr, receiver.address());
+    COROSIG_CO_TRY(auto sender, UdpSocket::unbound());
+
+    // small enough for default receive buffer to hold all of it at once
+    constexpr size_t SIZE = 100000;
+    std::array<std::span<char const>, 1> source{std::span{g_large}.first(SIZE)};
+    FanOutSink to_udp{sender, {}, &receiver_addr};
+    COROSIG_CO_TRYV(co_await fan_out(r, source, to_udp));
+    COROSIG_REQUIRE(to_udp.progress == SIZE);
+
+    static std::array<char, UdpSocket::MAX_PAYLOAD_SIZE + 1> buf;
+    COROSIG_CO_TRY(size_t read, co_await receiver.recv_from(r, buf));
+    COROSIG_REQUIRE(read == UdpSocket::MAX_PAYLOAD_SIZE);
+    COROSIG_CO_TRY(read, co_await receiver.recv_from(r, buf));
+    COROSIG_REQUIRE(read == SIZE - UdpSocket::MAX_PAYLOAD_SIZE);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("fan_out drops a stuck sink without holding back others") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError, TimedOutError>> {
+    // nobody reads these pipes, so only pipe capacity gets through
+    COROSIG_CO_TRY(auto stuck, PipePair::make());
+    COROSIG_CO_TRY(auto fast, PipePair::make());
+    int capacity = ::fcntl(stuck.write.underlying_handle(), F_GETPIPE_SZ);
+    COROSIG_REQUIRE(capacity > 0);
+    std::array<std::span<char const>, 1> source{g_large};
+
+    FanOutSink to_stuck{stuck.write, {.timeout = 50ms}};
+    FanOutSink to_fast{fast.write, {.timeout = 50ms}};
+    to_fast.progress = g_large.size() - 10; // pretend most of it was already delivered
+    COROSIG_CO_TRYV(co_await fan_out(r, source, to_stuck, to_fast));
+
+    COROSIG_REQUIRE(!to_stuck.result);
+    COROSIG_REQUIRE(to_stuck.result.error().holds<TimedOutError>());
+    COROSIG_REQUIRE(to_stuck.progress == static_cast<size_t>(capacity));
+    COROSIG_REQUIRE(to_fast.result);
+    COROSIG_REQUIRE(to_fast.progress == g_large.size());
+
+    // the same sink being required fails the whole fan out
+    COROSIG_CO_TRY(auto stuck_again, PipePair::make());
+    FanOutSink required{stuck_again.write, {.timeout = 50ms, .required = true}};
+    auto res = co_await fan_out(r, source, required);
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<TimedOutError>());
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
@@ -2,14 +2,20 @@
 
 #include "corosig/ErrorTypes.hpp"
 #include "corosig/Result.hpp"
+#include "corosig/io/BufWriter.hpp"
 #include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
 #include "corosig/testing/Signals.hpp"
 #include "corosig/testing/TemporaryFileTestListener.hpp"
 
+#include <array>
 #include <catch2/catch_test_macros.hpp>
 #include <cstddef>
 #include <fstream>
 #include <span>
+#include <string>
+#include <string_view>
+#include <unistd.h>
 
 using namespace corosig;
 using namespace corosig::testing;
@@ -109,3 +115,123 @@ COROSIG_SIGHANDLER_TEST_CASE("Move semantics") {
   };
   COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
 }
+
+COROSIG_SIGHANDLER_TEST_CASE("Sync applies every durability policy") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(File file,
+                   co_await File::open(
+                       r, g_temp_test_file, File::OpenFlags::CREATE | File::OpenFlags::WRONLY));
+    COROSIG_REQUIRE(file.durability() == File::Durability::DEFAULT);
+
+    for (auto durability : {File::Durability::NONE,
+                            File::Durability::WRITE_BEHIND,
+                            File::Durability::DATA,
+                            File::Durability::FULL}) {
+      file.set_durability(durability);
+      COROSIG_REQUIRE(file.durability() == durability);
+      COROSIG_CO_TRYV(co_await file.write(r, "data"));
+      COROSIG_CO_TRYV(co_await file.sync(r));
+    }
+    co_return Ok();
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Sync reports errors unless durability is NONE") {
+  std::array<int, 2> fds;
+  COROSIG_REQUIRE(::pipe(fds.data()) == 0);
+  File read_end = File::make_from_os_specific_handle(fds[0]);
+  File write_end = File::make_from_os_specific_handle(fds[1]);
+
+  // pipes can not be synced
+  auto res = write_end.sync(reactor).block_on();
+  COROSIG_REQUIRE(!res.is_ok());
+  COROSIG_REQUIRE(res.error().holds<SyscallError>());
+
+  write_end.set_durability(File::Durability::NONE);
+  COROSIG_REQUIRE(write_end.sync(reactor).block_on().is_ok());
+}
+
+TEST_CASE("Close applies durability to a file written through BufWriter") {
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(File file,
+                     co_await File::open(r, g_temp_test_file,
+                                         File::OpenFlags::CREATE | File::OpenFlags::WRONLY |
+                                             File::OpenFlags::TRUNCATE));
+      BufWriter out{std::move(file), r.allocator(), 8};
+      // Both coalesced and passed through writes go around File's own write methods
+      COROSIG_CO_TRYV(co_await out.write(r, "log "));
+      COROSIG_CO_TRYV(co_await out.write(r, "record too large to buffer"));
+      COROSIG_CO_TRYV(co_await out.flush(r));
+
+      COROSIG_REQUIRE(out.sink().syncs_on_close());
+      out.sink().close();
+      COROSIG_REQUIRE(!out.sink().syncs_on_close());
+
+      COROSIG_CO_TRY(File read_only,
+                     co_await File::open(r, g_temp_test_file, File::OpenFlags::RDONLY));
+      COROSIG_REQUIRE(!read_only.syncs_on_close());
+
+      COROSIG_CO_TRY(File unsynced,
+                     co_await File::open(r, g_temp_test_file, File::OpenFlags::WRONLY));
+      unsynced.set_durability(File::Durability::NONE);
+      COROSIG_REQUIRE(!unsynced.syncs_on_close());
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  REQUIRE(read_file(g_temp_test_file) == "log record too large to buffer");
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("Positional reads and writes do not move file offset") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(File file,
+                   co_await File::open(
+                       r, g_temp_test_file, File::OpenFlags::CREATE | File::OpenFlags::RDWR));
+    COROSIG_CO_TRYV(co_await file.write(r, "0123456789"));
+
+    COROSIG_CO_TRY(size_t written, co_await file.write_at(r, std::string_view{"ab"}, 2));
+    COROSIG_REQUIRE(written == 2);
+    COROSIG_CO_TRYV(co_await file.write(r, "!"));
+
+    std::array<char, 16> buf{};
+    COROSIG_CO_TRY(size_t read, co_await file.read_at(r, buf, 0));
+    COROSIG_REQUIRE(std::string_view(buf.data(), read) == "01ab456789!");
+
+    std::array<char, 3> head{};
+    std::array<char, 4> tail{};
+    std::array<std::span<char>, 2> bufs{head, tail};
+    COROSIG_CO_TRY(read, co_await file.read_vectored_at(r, bufs, 6));
+    COROSIG_REQUIRE(read == 5);
+    COROSIG_REQUIRE(std::string_view(head.data(), head.size()) == "678");
+    COROSIG_REQUIRE(std::string_view(tail.data(), 2) == "9!");
+
+    std::array<std::span<char const>, 2> out{std::string_view{"xy"}, std::string_view{"z"}};
+    COROSIG_CO_TRY(written, co_await file.write_vectored_at(r, out, 0));
+    COROSIG_REQUIRE(written == 3);
+    COROSIG_CO_TRY(read, co_await file.read_at(r, buf, 0));
+    COROSIG_REQUIRE(std::string_view(buf.data(), read) == "xyzb456789!");
+    co_return Ok();
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+TEST_CASE("Parallel positional write puts every range in place") {
+  static std::string const content = make_content(10007);
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r,
+                  std::string_view content) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(File file,
+                     co_await File::open(
+                         r, g_temp_test_file, File::OpenFlags::CREATE | File::OpenFlags::WRONLY));
+      COROSIG_CO_TRYV(co_await file.write_at_parallel(r, content, 3, 4));
+      co_return Ok();
+    };
+    COROSIG_REQUIRE(foo(reactor, content).block_on().is_ok());
+  });
+
+  REQUIRE(read_file(g_temp_test_file) == std::string(3, '\0') + content);
+}
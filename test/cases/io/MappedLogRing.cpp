@@ -0,0 +1,132 @@
+#include "corosig/io/MappedLogRing.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+#include "corosig/testing/TemporaryFileTestListener.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+CATCH_REGISTER_LISTENER(TemporaryFileTestListener);
+
+std::string contents(MappedLogRing const &ring) {
+  std::string out;
+  for (std::span<char const> part : ring.readable_parts()) {
+    out.append(part.data(), part.size());
+  }
+  return out;
+}
+
+std::optional<MappedLogRing> g_ring;
+
+} // namespace
+
+TEST_CASE("MappedLogRing keeps the newest bytes") {
+  auto ring = MappedLogRing::open({.path = g_temp_test_file, .min_capacity = 1});
+  REQUIRE(ring);
+  REQUIRE(ring.value().capacity() >= 4096);
+  REQUIRE(contents(ring.value()).empty());
+
+  ring.value().append("hello ");
+  ring.value().append("world");
+  REQUIRE(contents(ring.value()) == "hello world");
+
+  std::string expected;
+  for (size_t i = 0; expected.size() < ring.value().capacity() + 100; ++i) {
+    std::string line = "line " + std::to_string(i) + '\n';
+    ring.value().append(line);
+    expected += line;
+  }
+  expected = "hello world" + expected;
+  REQUIRE(ring.value().size() == ring.value().capacity());
+  REQUIRE(ring.value().end() == expected.size());
+  REQUIRE(contents(ring.value()) == expected.substr(expected.size() - ring.value().capacity()));
+}
+
+TEST_CASE("MappedLogRing takes appends from many threads") {
+  auto ring = MappedLogRing::open({.path = g_temp_test_file, .min_capacity = 1 << 20});
+  REQUIRE(ring);
+
+  constexpr size_t THREADS = 4;
+  constexpr size_t RECORDS = 1000;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&ring, t] {
+      std::string record(16, static_cast<char>('a' + t));
+      for (size_t i = 0; i < RECORDS; ++i) {
+        ring.value().append(record);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(ring.value().seal());
+  std::string all = contents(ring.value());
+  REQUIRE(all.size() == THREADS * RECORDS * 16);
+  for (size_t i = 0; i < all.size(); i += 16) {
+    REQUIRE(std::string(16, all[i]) == all.substr(i, 16));
+  }
+}
+
+TEST_CASE("MappedLogRing contents and seal survive reopening") {
+  {
+    auto ring = MappedLogRing::open({.path = g_temp_test_file, .min_capacity = 4096});
+    REQUIRE(ring);
+    ring.value().append("before crash\n");
+    REQUIRE(ring.value().seal());
+    ring.value().append("torn");
+  }
+
+  auto kept = MappedLogRing::open(
+      {.path = g_temp_test_file, .min_capacity = 4096, .keep_contents = true});
+  REQUIRE(kept);
+  REQUIRE(kept.value().sealed() == 13);
+  REQUIRE(contents(kept.value()) == "before crash\ntorn");
+  REQUIRE(kept.value().sync());
+
+  auto reset = MappedLogRing::open({.path = g_temp_test_file, .min_capacity = 4096});
+  REQUIRE(reset);
+  REQUIRE(reset.value().sealed() == 0);
+  REQUIRE(contents(reset.value()).empty());
+}
+
+TEST_CASE("MappedLogRing is streamed into a pipe from signal handler") {
+  auto ring = MappedLogRing::open({.path = g_temp_test_file, .min_capacity = 4096});
+  REQUIRE(ring);
+  g_ring.emplace(std::move(ring.value()));
+  g_ring->append("logged before signal\n");
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      g_ring->append("logged in handler\n");
+      COROSIG_REQUIRE(g_ring->seal());
+
+      COROSIG_CO_TRY(auto pipe, PipePair::make());
+      COROSIG_CO_TRY(size_t written, co_await g_ring->write_to(r, pipe.write));
+      COROSIG_REQUIRE(written == g_ring->size());
+
+      std::array<char, 64> buf;
+      COROSIG_CO_TRY(size_t read, co_await pipe.read.read(r, std::span{buf}.first(written)));
+      COROSIG_REQUIRE(std::string_view(buf.data(), read) ==
+                      "logged before signal\nlogged in handler\n");
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+  g_ring.reset();
+}
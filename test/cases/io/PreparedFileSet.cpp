@@ -0,0 +1,74 @@
+#include "corosig/io/PreparedFileSet.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/File.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+PreparedFileSet g_files;
+
+} // namespace
+
+TEST_CASE("PreparedFileSet hands out allocated files and trims them on close") {
+  std::filesystem::path first = tmp_file();
+  std::filesystem::path second = tmp_file();
+  write_file(first.native(), "stale content of previous run");
+
+  std::array<char const *, 2> paths{first.c_str(), second.c_str()};
+  REQUIRE(g_files.prepare({.paths = paths, .reserve_size = 64 * 1024}));
+  REQUIRE(g_files.size() == 2);
+  REQUIRE(g_files.available() == 2);
+#ifdef __linux__
+  // space is allocated past the end of still empty file
+  REQUIRE(std::filesystem::file_size(first) == 0);
+  struct stat st {};
+  REQUIRE(::stat(first.c_str(), &st) == 0);
+  REQUIRE(st.st_blocks * 512 >= 64 * 1024);
+#else
+  REQUIRE(std::filesystem::file_size(first) == 64 * 1024);
+#endif
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      File *file = g_files.acquire();
+      COROSIG_REQUIRE(file != nullptr);
+      COROSIG_CO_TRYV(co_await file->write(r, "crash log"));
+
+      COROSIG_REQUIRE(g_files.acquire() != nullptr);
+      COROSIG_REQUIRE(g_files.acquire() == nullptr);
+      COROSIG_REQUIRE(g_files.available() == 0);
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  REQUIRE(g_files.close());
+  REQUIRE(g_files.size() == 0);
+  REQUIRE(read_file(first) == "crash log");
+  REQUIRE(std::filesystem::file_size(second) == 0);
+
+  std::filesystem::remove(first);
+  std::filesystem::remove(second);
+}
+
+TEST_CASE("PreparedFileSet fails to prepare a file in missing directory") {
+  std::array<char const *, 1> paths{"/nonexistent-directory/crash.log"};
+  PreparedFileSet files;
+  auto res = files.prepare({.paths = paths});
+  REQUIRE(!res);
+  REQUIRE(files.size() == 0);
+  REQUIRE(files.acquire() == nullptr);
+}
@@ -7,6 +7,8 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <string_view>
+#include <sys/un.h>
 
 namespace {
 
@@ -392,3 +394,36 @@ COROSIG_SIGHANDLER_TEST_CASE("Ipv6Addr to_sockaddr", "[ipv6]") {
   COROSIG_REQUIRE(str != nullptr);
   COROSIG_REQUIRE(std::string(str) == "2001:db8::1");
 }
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixAddr from_path", "[unix]") {
+  auto addr = UnixAddr::from_path("/tmp/collector.sock");
+  COROSIG_REQUIRE(addr.has_value());
+  COROSIG_REQUIRE(!addr->is_abstract());
+  COROSIG_REQUIRE(addr->name() == "/tmp/collector.sock");
+
+  SockaddrStorage storage = addr->to_sockaddr();
+  auto const &un = reinterpret_cast<sockaddr_un const &>(storage.native_storage);
+  COROSIG_REQUIRE(un.sun_family == AF_UNIX);
+  COROSIG_REQUIRE(std::strcmp(un.sun_path, "/tmp/collector.sock") == 0);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixAddr abstract", "[unix]") {
+  auto addr = UnixAddr::abstract("collector");
+  COROSIG_REQUIRE(addr.has_value());
+  COROSIG_REQUIRE(addr->is_abstract());
+  COROSIG_REQUIRE(addr->name() == "collector");
+
+  SockaddrStorage storage = addr->to_sockaddr();
+  auto const &un = reinterpret_cast<sockaddr_un const &>(storage.native_storage);
+  COROSIG_REQUIRE(un.sun_path[0] == '\0');
+  COROSIG_REQUIRE(std::strcmp(un.sun_path + 1, "collector") == 0);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixAddr rejects invalid names", "[unix]") {
+  std::array<char, UnixAddr::MAX_NAME_SIZE + 1> too_long;
+  too_long.fill('a');
+  COROSIG_REQUIRE(!UnixAddr::from_path(""));
+  COROSIG_REQUIRE(!UnixAddr::abstract(std::string_view{too_long.data(), too_long.size()}));
+  COROSIG_REQUIRE(UnixAddr::abstract(std::string_view{too_long.data(), too_long.size() - 1}));
+  COROSIG_REQUIRE(!UnixAddr::from_path(std::string_view{"with\0zero", 9}));
+}
@@ -0,0 +1,133 @@
+#include "corosig/io/TcpConnectionPool.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/Sleep.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/TcpListener.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <string_view>
+
+using namespace corosig;
+using namespace std::chrono_literals;
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpConnectionPool hands out established connections") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({.addr = Ipv4Addr::loopback().to_sockaddr(0)}));
+    SockaddrStorage target = listener.address().value();
+
+    TcpConnectionPool pool{{.target = target, .size = 3}};
+    COROSIG_CO_TRY(size_t ready, co_await pool.refill(r));
+    COROSIG_REQUIRE(ready == 3);
+    COROSIG_REQUIRE(pool.ready() == 3);
+
+    COROSIG_CO_TRY(auto client, pool.checkout());
+    COROSIG_REQUIRE(pool.ready() == 2);
+    COROSIG_CO_TRYV(co_await client.write(r, "hello"));
+
+    // Connections are accepted in the order pool has established them
+    std::array<AcceptResult, 3> servers;
+    for (AcceptResult &server : servers) {
+      COROSIG_CO_TRY(server, co_await listener.accept(r));
+    }
+    std::array<char, 8> buf;
+    COROSIG_CO_TRY(size_t read, co_await servers[0].incoming_connection.read_some(r, buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "hello");
+
+    pool.checkin(std::move(client));
+    COROSIG_REQUIRE(pool.ready() == 3);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpConnectionPool skips and replaces connections closed by peer") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({.addr = Ipv4Addr::loopback().to_sockaddr(0)}));
+    SockaddrStorage target = listener.address().value();
+
+    TcpConnectionPool pool{{
+        .target = target,
+        .size = 2,
+        .keepalive_idle = std::chrono::seconds{10},
+    }};
+    COROSIG_CO_TRYV(co_await pool.refill(r));
+
+    for (size_t i = 0; i < 2; ++i) {
+      COROSIG_CO_TRY(auto server, co_await listener.accept(r));
+      server.incoming_connection.close();
+    }
+
+    auto dead = pool.checkout();
+    COROSIG_REQUIRE(!dead);
+    COROSIG_REQUIRE(dead.error().value == ENOTCONN);
+    COROSIG_REQUIRE(pool.ready() == 0);
+
+    COROSIG_CO_TRY(size_t ready, co_await pool.refill(r));
+    COROSIG_REQUIRE(ready == 2);
+    COROSIG_REQUIRE(pool.checkout());
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpConnectionPool refill reports connect failure") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage target;
+    {
+      // Take a free port and release it, so nobody listens there
+      COROSIG_CO_TRY(auto listener,
+                     TcpListener::make({.addr = Ipv4Addr::loopback().to_sockaddr(0)}));
+      target = listener.address().value();
+    }
+
+    TcpConnectionPool pool{{.target = target, .size = 2}};
+    auto res = co_await pool.refill(r);
+    COROSIG_REQUIRE(!res);
+    COROSIG_REQUIRE(res.error().holds<SyscallError>());
+    COROSIG_REQUIRE(pool.ready() == 0);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpConnectionPool maintain replaces checked out connections") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({.addr = Ipv4Addr::loopback().to_sockaddr(0)}));
+    SockaddrStorage target = listener.address().value();
+
+    TcpConnectionPool pool{{.target = target, .size = 1}};
+    {
+      auto maintenance = pool.maintain(r, 10ms);
+      co_await Sleep{50ms};
+      COROSIG_REQUIRE(pool.ready() == 1);
+
+      COROSIG_CO_TRY(auto client, pool.checkout());
+      COROSIG_REQUIRE(pool.ready() == 0);
+      co_await Sleep{50ms};
+      COROSIG_REQUIRE(pool.ready() == 1);
+    }
+
+    // Stopping maintenance in the middle of connect leaves the slot free for the next refill
+    COROSIG_CO_TRY(auto client, pool.checkout());
+    {
+      auto stopped = pool.maintain(r, 10ms);
+    }
+    COROSIG_CO_TRY(size_t ready, co_await pool.refill(r));
+    COROSIG_REQUIRE(ready == 1);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
@@ -7,6 +7,10 @@
 #include "corosig/testing/Signals.hpp"
 
 #include <array>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <span>
 #include <string_view>
 
 namespace {
@@ -285,3 +289,70 @@ COROSIG_SIGHANDLER_TEST_CASE("TcpListener destructor closes handle") {
     COROSIG_REQUIRE(sock.underlying_handle() == fd);
   }
 }
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpListener accept_batch drains the backlog") {
+  auto test_coro = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({.addr = Ipv4Addr::loopback().to_sockaddr(0)}));
+    SockaddrStorage addr = listener.address().value();
+
+    constexpr static size_t NUM_CONNECTIONS = 4;
+    std::array<TcpSocket, NUM_CONNECTIONS> clients;
+    for (TcpSocket &client : clients) {
+      COROSIG_CO_TRY(client, co_await TcpSocket::connect(r, addr));
+    }
+
+    std::array<AcceptResult, NUM_CONNECTIONS + 2> accepted;
+    size_t total = 0;
+    while (total < NUM_CONNECTIONS) {
+      COROSIG_CO_TRY(size_t now,
+                     co_await listener.accept_batch(r, std::span{accepted}.subspan(total)));
+      total += now;
+    }
+    COROSIG_REQUIRE(total == NUM_CONNECTIONS);
+    for (size_t i = 0; i < total; ++i) {
+      int fd = accepted[i].incoming_connection.underlying_handle();
+      COROSIG_REQUIRE(fd >= 0);
+      COROSIG_REQUIRE((::fcntl(fd, F_GETFL) & O_NONBLOCK) != 0);
+      COROSIG_REQUIRE((::fcntl(fd, F_GETFD) & FD_CLOEXEC) != 0);
+    }
+
+    auto nothing = listener.try_accept_batch(accepted);
+    COROSIG_REQUIRE(!nothing);
+    COROSIG_REQUIRE(nothing.error().value == EWOULDBLOCK);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(test_coro(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpListener with defer_accept surfaces connections with data") {
+  auto test_coro = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    using namespace std::chrono_literals;
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({
+                       .addr = Ipv4Addr::loopback().to_sockaddr(0),
+                       .defer_accept = 5s,
+                   }));
+    SockaddrStorage addr = listener.address().value();
+
+    COROSIG_CO_TRY(auto client, co_await TcpSocket::connect(r, addr));
+
+    auto nothing = listener.try_accept();
+    COROSIG_REQUIRE(!nothing);
+    COROSIG_REQUIRE(nothing.error().value == EWOULDBLOCK);
+
+    COROSIG_CO_TRYV(co_await client.write(r, "data"));
+
+    std::array<AcceptResult, 1> accepted;
+    COROSIG_CO_TRY(size_t count, co_await listener.accept_batch(r, accepted));
+    COROSIG_REQUIRE(count == 1);
+
+    std::array<char, 8> buf;
+    COROSIG_CO_TRY(size_t read, accepted[0].incoming_connection.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "data");
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(test_coro(reactor).block_on().is_ok());
+}
@@ -6,8 +6,10 @@
 #include "corosig/reactor/Reactor.hpp"
 #include "corosig/testing/Signals.hpp"
 
+#include <array>
 #include <netinet/in.h>
 #include <span>
+#include <string_view>
 #include <sys/socket.h>
 #include <thread>
 #include <unistd.h>
@@ -215,3 +217,29 @@ COROSIG_SIGHANDLER_TEST_CASE("TcpSocket connect_from") {
   };
   COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
 }
+
+COROSIG_SIGHANDLER_TEST_CASE("TcpSocket connect_and_send delivers payload") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto listener,
+                   TcpListener::make({
+                       .addr = Ipv4Addr::loopback().to_sockaddr(0),
+                       .fastopen_queue_size = 16,
+                   }));
+    SockaddrStorage target = listener.address().value();
+
+    // First connection only obtains a fast open cookie, second one may already use it
+    for (size_t i = 0; i < 2; ++i) {
+      constexpr std::string_view MSG = "crash log riding on SYN";
+      COROSIG_CO_TRY(auto client, co_await TcpSocket::connect_and_send(r, target, MSG));
+      COROSIG_CO_TRY(AcceptResult ar, co_await listener.accept(r));
+
+      std::array<char, 64> buf;
+      COROSIG_CO_TRY(size_t read,
+                     co_await ar.incoming_connection.read(r, std::span{buf}.first(MSG.size())));
+      COROSIG_REQUIRE(std::string_view{buf.data(), read} == MSG);
+    }
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
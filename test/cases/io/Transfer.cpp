@@ -0,0 +1,78 @@
+#include "corosig/io/Transfer.hpp"
+
+#include "corosig/io/File.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/io/TcpSocket.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/FileHelpers.hpp"
+#include "corosig/testing/Signals.hpp"
+#include "corosig/testing/SocketHelpers.hpp"
+#include "corosig/testing/TemporaryFileTestListener.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace corosig;
+using namespace corosig::testing;
+
+namespace {
+
+CATCH_REGISTER_LISTENER(TemporaryFileTestListener);
+
+} // namespace
+
+TEST_CASE("transfer sends file range into TcpSocket") {
+  constexpr static uint16_t PORT = 5570;
+
+  std::string file_content = make_content(10000);
+  write_temp_file(file_content);
+
+  std::string received;
+  std::thread server = start_collecting_server(PORT, received);
+
+  run_in_sighandler([](Reactor &reactor) {
+    auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+      COROSIG_CO_TRY(auto file, co_await File::open(r, g_temp_test_file, File::OpenFlags::RDONLY));
+      COROSIG_CO_TRY(auto sock,
+                     co_await TcpSocket::connect(r, Ipv4Addr::loopback().to_sockaddr(PORT)));
+
+      COROSIG_CO_TRY(size_t sent, co_await transfer(r, file, sock, 100, 9000));
+      COROSIG_REQUIRE(sent == 9000);
+
+      // range past the end of file is cut short
+      COROSIG_CO_TRY(sent, co_await transfer(r, file, sock, 9990, 100));
+      COROSIG_REQUIRE(sent == 10);
+      co_return Ok{};
+    };
+    COROSIG_REQUIRE(foo(reactor).block_on());
+  });
+
+  server.join();
+  REQUIRE(received == file_content.substr(100, 9000) + file_content.substr(9990));
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("transfer moves data between pipes") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto first, PipePair::make());
+    COROSIG_CO_TRY(auto second, PipePair::make());
+
+    constexpr std::string_view MSG = "spliced through two pipes";
+    COROSIG_CO_TRYV(co_await first.write.write(r, MSG));
+    first.write.close();
+
+    COROSIG_CO_TRY(size_t moved, co_await transfer(r, first.read, second.write, 1024));
+    COROSIG_REQUIRE(moved == MSG.size());
+
+    std::array<char, 64> buf;
+    COROSIG_CO_TRY(size_t read, second.read.try_read_some(buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == MSG);
+    co_return Ok{};
+  };
+
+  COROSIG_REQUIRE(foo(reactor).block_on());
+}
@@ -5,6 +5,8 @@
 #include "corosig/testing/Signals.hpp"
 
 #include <array>
+#include <cerrno>
+#include <netinet/in.h>
 #include <string_view>
 #include <sys/socket.h>
 
@@ -280,3 +282,113 @@ COROSIG_SIGHANDLER_TEST_CASE("UdpSocket: underlying_handle returns correct value
 
   COROSIG_REQUIRE(handle >= 0);
 }
+
+COROSIG_SIGHANDLER_TEST_CASE("UdpSocket: send_batch and recv_batch move several datagrams") {
+  auto test_coro = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage local = Ipv4Addr::loopback().to_sockaddr(23456);
+
+    COROSIG_CO_TRY(auto receiver, UdpSocket::bound(local));
+    COROSIG_CO_TRY(auto sender, UdpSocket::unbound());
+
+    // more than MAX_BATCH_SIZE to cross syscall boundary
+    constexpr size_t COUNT = UdpSocket::MAX_BATCH_SIZE + 4;
+    std::array<std::array<char, 1>, COUNT> payloads;
+    std::array<OutgoingDatagram, COUNT> outgoing;
+    for (size_t i = 0; i < COUNT; ++i) {
+      payloads[i][0] = static_cast<char>('a' + i);
+      outgoing[i] = OutgoingDatagram{.data = payloads[i], .dest = &local};
+    }
+
+    COROSIG_CO_TRY(size_t sent, co_await sender.send_batch(r, outgoing));
+    COROSIG_REQUIRE(sent == COUNT);
+
+    std::array<std::array<char, 8>, COUNT + 1> buffers;
+    std::array<SockaddrStorage, COUNT + 1> sources;
+    std::array<IncomingDatagram, COUNT + 1> incoming;
+    for (size_t i = 0; i < incoming.size(); ++i) {
+      incoming[i] = IncomingDatagram{.buffer = buffers[i], .source = &sources[i]};
+    }
+
+    COROSIG_CO_TRY(size_t received, co_await receiver.recv_batch(r, incoming));
+    COROSIG_REQUIRE(received == COUNT);
+    COROSIG_CO_TRY(auto sender_addr, sender.address());
+    for (size_t i = 0; i < COUNT; ++i) {
+      COROSIG_REQUIRE(incoming[i].size == 1);
+      COROSIG_REQUIRE(buffers[i][0] == static_cast<char>('a' + i));
+      COROSIG_REQUIRE(reinterpret_cast<sockaddr_in const &>(sources[i].native_storage).sin_port ==
+                      reinterpret_cast<sockaddr_in const &>(sender_addr.native_storage).sin_port);
+    }
+
+    auto nothing = receiver.try_recv_batch(incoming);
+    COROSIG_REQUIRE(!nothing);
+    COROSIG_REQUIRE(nothing.error().value == EAGAIN);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(test_coro(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UdpSocket: recv_batch reports size of truncated datagram") {
+  auto test_coro = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage local = Ipv4Addr::loopback().to_sockaddr(23457);
+
+    COROSIG_CO_TRY(auto receiver, UdpSocket::bound(local));
+    COROSIG_CO_TRY(auto sender, UdpSocket::unbound());
+
+    std::string_view msg = "longer than buffer";
+    COROSIG_CO_TRYV(co_await sender.send_to(r, msg, local));
+
+    std::array<char, 4> buf;
+    std::array<IncomingDatagram, 1> incoming{IncomingDatagram{.buffer = buf}};
+    COROSIG_CO_TRY(size_t received, co_await receiver.recv_batch(r, incoming));
+    COROSIG_REQUIRE(received == 1);
+    COROSIG_REQUIRE(incoming[0].size == msg.size());
+    COROSIG_REQUIRE(std::string_view{buf.data(), buf.size()} == "long");
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(test_coro(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UdpSocket: send_segmented splits buffer into datagrams") {
+  auto test_coro = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage local = Ipv4Addr::loopback().to_sockaddr(23458);
+
+    COROSIG_CO_TRY(auto receiver, UdpSocket::bound(local));
+    COROSIG_CO_TRY(auto sender, UdpSocket::unbound());
+
+    constexpr size_t SEGMENT_SIZE = 100;
+    std::array<char, (10 * SEGMENT_SIZE) + 24> payload;
+    for (size_t i = 0; i < payload.size(); ++i) {
+      payload[i] = static_cast<char>(i / SEGMENT_SIZE);
+    }
+
+    COROSIG_CO_TRY(size_t sent, co_await sender.send_segmented(r, payload, SEGMENT_SIZE, local));
+    COROSIG_REQUIRE(sent == payload.size());
+
+    std::array<std::array<char, SEGMENT_SIZE>, 12> buffers;
+    std::array<IncomingDatagram, 12> incoming;
+    for (size_t i = 0; i < incoming.size(); ++i) {
+      incoming[i].buffer = buffers[i];
+    }
+
+    size_t received = 0;
+    while (received < 11) {
+      COROSIG_CO_TRY(size_t now,
+                     co_await receiver.recv_batch(r, std::span{incoming}.subspan(received)));
+      received += now;
+    }
+    COROSIG_REQUIRE(received == 11);
+    for (size_t i = 0; i < received; ++i) {
+      COROSIG_REQUIRE(incoming[i].size == (i == 10 ? 24 : SEGMENT_SIZE));
+      COROSIG_REQUIRE(buffers[i][0] == static_cast<char>(i));
+    }
+
+    auto bad = sender.try_send_segmented(payload, 0, local);
+    COROSIG_REQUIRE(!bad);
+    COROSIG_REQUIRE(bad.error().value == EINVAL);
+
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(test_coro(reactor).block_on().is_ok());
+}
@@ -0,0 +1,154 @@
+#include "corosig/io/UnixSocket.hpp"
+
+#include "corosig/ErrorTypes.hpp"
+#include "corosig/io/Pipe.hpp"
+#include "corosig/io/Sockaddr.hpp"
+#include "corosig/reactor/Reactor.hpp"
+#include "corosig/testing/Signals.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace corosig;
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixStream pair exchanges data") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pair, UnixStream::make_pair());
+
+    COROSIG_CO_TRYV(co_await pair[0].write(r, "ping"));
+    std::array<char, 4> buf;
+    COROSIG_CO_TRY(size_t read, co_await pair[1].read(r, buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "ping");
+
+    auto nothing = pair[1].try_read_some(buf);
+    COROSIG_REQUIRE(!nothing);
+    COROSIG_REQUIRE(nothing.error().value == EAGAIN);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixListener accepts connection at abstract address") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage addr = UnixAddr::abstract("corosig.test.listener")->to_sockaddr();
+    COROSIG_CO_TRY(auto listener, UnixListener::make({.addr = addr}));
+
+    COROSIG_CO_TRY(SockaddrStorage bound, listener.address());
+    auto const &bound_un = reinterpret_cast<sockaddr_un const &>(bound.native_storage);
+    COROSIG_REQUIRE(bound_un.sun_path[0] == '\0');
+    COROSIG_REQUIRE(std::string_view{bound_un.sun_path + 1} == "corosig.test.listener");
+
+    COROSIG_CO_TRY(auto client, co_await UnixStream::connect(r, addr));
+    COROSIG_CO_TRY(auto server, co_await listener.accept(r));
+
+    COROSIG_CO_TRYV(co_await client.write(r, "hello"));
+    std::array<char, 5> buf;
+    COROSIG_CO_TRY(size_t read, co_await server.read(r, buf));
+    COROSIG_REQUIRE(std::string_view{buf.data(), read} == "hello");
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixListener listens at filesystem path") {
+  constexpr char const *PATH = "/tmp/corosig-test-listener.sock";
+  ::unlink(PATH);
+
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage addr = UnixAddr::from_path(PATH)->to_sockaddr();
+    COROSIG_CO_TRY(auto listener, UnixListener::make({.addr = addr}));
+
+    auto occupied = UnixListener::make({.addr = addr});
+    COROSIG_REQUIRE(!occupied);
+    COROSIG_REQUIRE(occupied.error().value == EADDRINUSE);
+
+    COROSIG_CO_TRY(auto client, co_await UnixStream::connect(r, addr));
+    COROSIG_CO_TRY(auto server, co_await listener.accept(r));
+    COROSIG_REQUIRE((::fcntl(server.underlying_handle(), F_GETFL) & O_NONBLOCK) != 0);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+  ::unlink(PATH);
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixDatagram send_to and recv_from") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    SockaddrStorage addr = UnixAddr::abstract("corosig.test.datagram")->to_sockaddr();
+    COROSIG_CO_TRY(auto receiver, UnixDatagram::bound(addr));
+    COROSIG_CO_TRY(auto sender, UnixDatagram::unbound());
+
+    constexpr std::string_view MSG = "datagram over unix socket";
+    COROSIG_CO_TRY(size_t sent, co_await sender.send_to(r, MSG, addr));
+    COROSIG_REQUIRE(sent == MSG.size());
+
+    // Reported size is not truncated
+    std::array<char, 8> buf;
+    COROSIG_CO_TRY(size_t received, co_await receiver.recv_from(r, buf));
+    COROSIG_REQUIRE(received == MSG.size());
+    COROSIG_REQUIRE(std::string_view{buf.data(), buf.size()} == MSG.substr(0, buf.size()));
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixStream passes handles") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pair, UnixStream::make_pair());
+    COROSIG_CO_TRY(auto pipe, PipePair::make());
+
+    std::array<os::Handle, 1> sent_handles{pipe.write.underlying_handle()};
+    COROSIG_CO_TRY(size_t sent,
+                   co_await pair[0].send_handles(r, std::string_view{"h"}, sent_handles));
+    COROSIG_REQUIRE(sent == 1);
+    pipe.write.close();
+
+    std::array<char, 4> buf;
+    std::array<os::Handle, 4> received_handles;
+    COROSIG_CO_TRY(auto received, co_await pair[1].recv_handles(r, buf, received_handles));
+    COROSIG_REQUIRE(received.size == 1);
+    COROSIG_REQUIRE(buf[0] == 'h');
+    COROSIG_REQUIRE(received.handles == 1);
+    COROSIG_REQUIRE((::fcntl(received_handles[0], F_GETFD) & FD_CLOEXEC) != 0);
+
+    // Received handle refers to the same pipe, even though the original one is closed
+    auto passed_write = PipeWrite::make_from_os_specific_handle(received_handles[0]);
+    COROSIG_CO_TRYV(co_await passed_write.write(r, "through passed fd"));
+    std::array<char, 32> out;
+    COROSIG_CO_TRY(size_t read, pipe.read.try_read_some(out));
+    COROSIG_REQUIRE(std::string_view{out.data(), read} == "through passed fd");
+
+    auto empty = pair[0].try_send_handles({}, sent_handles);
+    COROSIG_REQUIRE(!empty);
+    COROSIG_REQUIRE(empty.error().value == EINVAL);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
+
+COROSIG_SIGHANDLER_TEST_CASE("UnixDatagram passes several handles in one message") {
+  auto foo = [](Reactor &r) -> Fut<void, Error<AllocationError, SyscallError>> {
+    COROSIG_CO_TRY(auto pair, UnixDatagram::make_pair());
+    COROSIG_CO_TRY(auto first, PipePair::make());
+    COROSIG_CO_TRY(auto second, PipePair::make());
+
+    std::array<os::Handle, 2> sent_handles{first.read.underlying_handle(),
+                                           second.read.underlying_handle()};
+    COROSIG_CO_TRYV(co_await pair[0].send_handles(r, std::string_view{"logs"}, sent_handles));
+
+    std::array<char, 8> buf;
+    std::array<os::Handle, 1> received_handles;
+    COROSIG_CO_TRY(auto received, co_await pair[1].recv_handles(r, buf, received_handles));
+    COROSIG_REQUIRE(std::string_view{buf.data(), received.size} == "logs");
+    // Only one slot, so second handle was dropped by kernel
+    COROSIG_REQUIRE(received.handles == 1);
+    ::close(received_handles[0]);
+    co_return Ok{};
+  };
+  COROSIG_REQUIRE(foo(reactor).block_on().is_ok());
+}
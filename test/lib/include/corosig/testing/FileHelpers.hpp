@@ -1,12 +1,19 @@
 #ifndef COROSIG_TESTING_FILE_HELPERS_HPP
 #define COROSIG_TESTING_FILE_HELPERS_HPP
 
+#include <cstddef>
 #include <filesystem>
+#include <string>
+#include <string_view>
 
 namespace corosig::testing {
 
 std::filesystem::path tmp_file();
 void write_file(std::string_view path, std::string_view content);
+std::string read_file(std::filesystem::path const &path);
+
+/// Make size bytes of repeating lowercase alphabet, so misplaced ranges are easy to spot
+std::string make_content(size_t size);
 
 } // namespace corosig::testing
 
@@ -0,0 +1,15 @@
+#ifndef COROSIG_TESTING_SOCKET_HELPERS_HPP
+#define COROSIG_TESTING_SOCKET_HELPERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace corosig::testing {
+
+/// Listen on loopback port and append everything the first client sends into out until it closes
+std::thread start_collecting_server(uint16_t port, std::string &out);
+
+} // namespace corosig::testing
+
+#endif
@@ -2,9 +2,12 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <random>
+#include <string>
 
 namespace corosig::testing {
 
@@ -26,4 +29,18 @@ void write_file(std::string_view path, std::string_view content) {
   ofs << content;
 }
 
+std::string read_file(std::filesystem::path const &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  return std::string{std::istreambuf_iterator<char>{ifs}, {}};
+}
+
+std::string make_content(size_t size) {
+  std::string content;
+  content.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    content += static_cast<char>('a' + (i % 26));
+  }
+  return content;
+}
+
 } // namespace corosig::testing
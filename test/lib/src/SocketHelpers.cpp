@@ -0,0 +1,44 @@
+#include "corosig/testing/SocketHelpers.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace corosig::testing {
+
+std::thread start_collecting_server(uint16_t port, std::string &out) {
+  int srv_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(srv_fd >= 0);
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = ::htons(port);
+  addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+
+  int opt = 1;
+  setsockopt(srv_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  REQUIRE(::bind(srv_fd, (sockaddr *)&addr, sizeof(addr)) == 0);
+  REQUIRE(::listen(srv_fd, 1) == 0);
+
+  return std::thread([srv_fd, &out]() {
+    int client = ::accept(srv_fd, nullptr, nullptr);
+    std::array<char, 1024> buf;
+    while (true) {
+      ssize_t n = ::read(client, buf.begin(), sizeof(buf));
+      if (n <= 0) {
+        break;
+      }
+      out.append(buf.begin(), static_cast<size_t>(n));
+    }
+    ::close(client);
+    ::close(srv_fd);
+  });
+}
+
+} // namespace corosig::testing
@@ -52,6 +52,7 @@ target("corosig")
     add_headerfiles("include/(**.hpp)")
     set_default(true)
     add_packages("boost", { external = true, public = true })
+    add_syslinks("pthread", { public = true })
 
     before_build(function (target)
         if is_mode("asan") then
@@ -114,3 +115,17 @@ for _, file in ipairs(os.files("example/**.cpp")) do
         add_files(file)
     target_end()
 end
+
+
+-- Dry runs of example handlers which report how much memory they really need
+for _, file in ipairs(os.files("example/**.cpp")) do
+    local name = "calibrate." .. path.basename(file)
+    target(name)
+        set_enabled(has_config("examples"))
+        set_default(false)
+        set_kind("binary")
+        add_deps("corosig")
+        add_defines("COROSIG_CALIBRATE_SIGHANDLERS=1")
+        add_files(file)
+    target_end()
+end